@@ -5,3 +5,6 @@
 #define MAPICON_ICON 1
 #define MAPICON_ICON_HOVER 2
 #define MAPICON_ICON_SELECTED 3
+
+// Size of the buckets for icons with a static position
+#define BUCKET_SIZE 100
@@ -1,2 +1,10 @@
 #define MODULE ConfiCaching
 #include "\tc\CLib\addons\CLib\CLib_Macros.hpp"
+
+#define PREFETCH_ROOT 0
+#define PREFETCH_REQUESTED 1
+#define PREFETCH_PROPERTYINDEX 2
+#define PREFETCH_CLASSINDEX 3
+#define PREFETCH_VALUES 4
+#define PREFETCH_PROPERTIES 5
+#define PREFETCH_CLASSES 6
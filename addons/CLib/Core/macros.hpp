@@ -6,3 +6,16 @@
 #else
     #define CMP(var) compileFinal var
 #endif
+
+#define CACHEDCALL_EXPIRY 0
+#define CACHEDCALL_VALUE 1
+#define CACHEDCALL_LASTUSE 2
+#define CACHEDCALL_INDEX 3
+
+#define CACHEDCALL_HITS 0
+#define CACHEDCALL_MISSES 1
+#define CACHEDCALL_EVICTIONS 2
+#define CACHEDCALL_EXPIRED 3
+
+#define GRID_CELL(coord) (floor ((coord) / GVAR(spatialGridCellSize)))
+#define GRID_KEY(cellX,cellY) format ["%1_%2", cellX, cellY]
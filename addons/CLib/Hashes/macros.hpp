@@ -3,5 +3,33 @@
 
 #define HASH_KEYS 0
 #define HASH_VALUES 1
+#define HASH_BUCKETS 2
 
 #define HASH_NULL [[], []]
+
+#define HASH_MINBUCKETS 16
+// Average amount of keys per bucket before the buckets get doubled
+#define HASH_MAXLOAD 2
+
+// Integers are their own hash code, everything else hashes a few characters from the start, middle and end of a string
+// Objects, groups and other keys use hashValue because their str changes when they get renamed
+// The modulus keeps every step below 2^24 so the result is exact with single precision numbers
+#define HASH_CODE(key) (if (key isEqualType 0) then {\
+    floor abs key\
+} else {\
+    private _chars = toArray (if (key isEqualType "") then {key} else {hashValue key});\
+    private _count = count _chars;\
+    private _code = _count;\
+    {\
+        _code = (_code * 31 + _x) mod 65521;\
+    } forEach ((_chars select [0, 4]) + (_chars select [floor (_count / 2), 1]) + (_chars select [(_count - 4) max 0, 4]));\
+    _code\
+})
+
+#define HASH_BUCKET(hashSet,key) ((hashSet select HASH_BUCKETS) select (HASH_CODE(key) mod (count (hashSet select HASH_BUCKETS))))
+
+// Hashes from before the buckets existed get their buckets on first use
+#define HASH_PREPARE(hashSet) if (count hashSet < 3) then {[hashSet] call FUNC(rehash);}
+
+// Grows the buckets once before many keys get inserted
+#define HASH_RESERVE(hashSet,size) if (count hashSet < 3 || {(size) > HASH_MAXLOAD * count (hashSet select HASH_BUCKETS)}) then {[hashSet, size] call FUNC(rehash);}
@@ -5,3 +5,9 @@
 #define MAPICON_ICON 1
 #define MAPICON_ICON_HOVER 2
 #define MAPICON_ICON_SELECTED 3
+
+// Size of the cells of the hit test grid in meters
+#define MAPGRAPHICS_CELLSIZE 500
+// Cells are clamped to 4096 per axis so the key stays an exact integer
+#define MAPGRAPHICS_CELL(coord) ((floor ((coord) / MAPGRAPHICS_CELLSIZE) max 0) min 4095)
+#define MAPGRAPHICS_CELLKEY(cellX,cellY) str ((cellX) + (cellY) * 4096)
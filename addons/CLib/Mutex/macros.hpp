@@ -1,2 +1,21 @@
 #define MODULE Mutex
 #include "\tc\CLib\addons\CLib\CLib_Macros.hpp"
+
+// Server side state of a mutex
+#define MUTEX_CLIENT 0
+#define MUTEX_QUEUE 1
+#define MUTEX_GRANTTIME 2
+#define MUTEX_SERIAL 3
+#define MUTEX_REQUESTTIMES 4
+
+#define MUTEX_NULL [0, [], 0, 0, []]
+
+#define MUTEXSTATS_REQUESTS 0
+#define MUTEXSTATS_CONTENDED 1
+#define MUTEXSTATS_GRANTS 2
+#define MUTEXSTATS_TIMEOUTS 3
+#define MUTEXSTATS_RENEWALS 4
+#define MUTEXSTATS_TOTALWAIT 5
+#define MUTEXSTATS_MAXWAIT 6
+
+#define MUTEXSTATS_ADD(index,value) GVAR(mutexStats) set [index, (GVAR(mutexStats) select index) + (value)]
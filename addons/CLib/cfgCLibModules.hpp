@@ -11,6 +11,7 @@ class CfgCLibModules {
             FNC(build3dGraphicsCache);
             FNC(clientInit);
             FNC(draw3dGraphics);
+            APIFNC(get3dGraphicsStats);
             APIFNC(remove3dGraphics);
         };
 
@@ -33,10 +34,15 @@ class CfgCLibModules {
 
         MODULE(ConfigCaching) {
             dependency[] = {"CLib/Namespaces"};
+            FNC(addPrefetchEntry);
             APIFNC(configProperties);
+            APIFNC(getConfigCacheStats);
             APIFNC(getConfigDataCached);
             APIFNC(getConfigData);
+            FNC(getModSetHash);
+            APIFNC(getPrefetchedConfigData);
             FNC(init);
+            APIFNC(prefetchConfig);
             APIFNC(returnParents);
         };
 
@@ -49,6 +55,7 @@ class CfgCLibModules {
             MODULE(Autoload) {
                 FNCSERVER(autoloadEntryPoint);
                 FNC(callModules);
+                FNCSERVER(hashString);
                 APIFNCSERVER(loadModules);
                 FNCSERVER(loadModulesServer);
                 FNCSERVER(sendFunctions);
@@ -68,6 +75,8 @@ class CfgCLibModules {
 
             MODULE(ExtensionFramework) {
                 APIFNC(callExtension);
+                APIFNC(cancelExtensionCall);
+                APIFNC(databaseBatch);
                 APIFNCSERVER(extensionRequest);
                 FNCSERVER(extensionFetch);
                 FNC(initExtensionFramework);
@@ -75,6 +84,7 @@ class CfgCLibModules {
             };
 
             MODULE(Misc) {
+                FNC(benchmarkNearUnits);
                 APIFNC(blurScreen);
                 APIFNC(cachedCall);
                 APIFNC(codeToString);
@@ -84,16 +94,20 @@ class CfgCLibModules {
                 APIFNC(deleteAtEntry);
                 APIFNC(directCall);
                 APIFNC(disableUserInput);
+                FNC(evictCachedCall);
                 APIFNC(getPos);
                 APIFNC(fileExist);
                 APIFNC(flatConfigPath);
                 APIFNC(findSavePosition);
                 APIFNC(fixFloating);
                 APIFNC(fixPosition);
+                APIFNC(getCachedCallStats);
                 APIFNC(getFOV);
                 APIFNC(getNearUnits);
+                APIFNC(getUnitsInRadius);
                 APIFNC(groupPlayers);
                 APIFNC(inFOV);
+                FNC(initSpatialGrid);
                 FNC(initVoiceDetection);
                 APIFNC(isKindOfArray);
                 APIFNC(log);
@@ -102,11 +116,15 @@ class CfgCLibModules {
                 APIFNC(moduleLoaded);
                 APIFNC(name);
                 APIFNC(registerEntryPoint);
+                FNC(removeCachedCall);
                 APIFNC(sanitizeString);
+                FNC(searchNearUnits);
                 APIFNC(shuffleArray);
+                FNC(sweepCachedCall);
                 APIFNC(setVariablePublic);
                 APIFNC(textTiles);
                 APIFNC(toFixedNumber);
+                FNC(updateSpatialGrid);
             };
 
             MODULE(MissionModuleLoader) {
@@ -119,12 +137,16 @@ class CfgCLibModules {
             APIFNC(addEventHandler);
             APIFNC(addIgnoredEventLog);
             FNC(clientInit);
+            FNC(flushEvents);
             APIFNC(globalEvent);
             FNC(hcInit);
             FNC(init);
             APIFNC(invokePlayerChanged);
             APIFNC(localEvent);
+            FNC(receiveEvents);
             APIFNC(removeEventhandler);
+            APIFNC(removePersistentEvent);
+            FNC(sendEvent);
             APIFNC(serverEvent);
             FNC(serverInit);
             APIFNC(targetEvent);
@@ -136,7 +158,7 @@ class CfgCLibModules {
         };
 
         MODULE(Gear) {
-            dependency[] = {"CLib/PerFrame"};
+            dependency[] = {"CLib/PerFrame", "CLib/ConfigCaching"};
             MODULE(Loadout) {
                 APIFNC(getAllLoadouts);
                 APIFNC(getLoadoutDetails);
@@ -155,6 +177,7 @@ class CfgCLibModules {
         };
 
         MODULE(Hashes) {
+            FNC(benchmarkHashes);
             APIFNC(containsKey);
             APIFNC(containsValue);
             APIFNC(countHash);
@@ -167,7 +190,9 @@ class CfgCLibModules {
             APIFNC(hashToTuple);
             APIFNC(isHash);
             APIFNC(namespaceToHash);
+            FNC(rehash);
             APIFNC(setHash);
+            APIFNC(tupleToHash);
         };
 
         MODULE(Interaction) {
@@ -207,6 +232,7 @@ class CfgCLibModules {
             APIFNC(buildMapGraphicsCache);
             FNC(clientInit);
             APIFNC(drawMapGraphics);
+            FNC(indexMapGraphicsGroup);
             APIFNC(mapGraphicsMouseButtonClick);
             APIFNC(mapGraphicsMouseButtonDblClick);
             APIFNC(mapGraphicsMouseMoving);
@@ -215,14 +241,25 @@ class CfgCLibModules {
             APIFNC(removeMapGraphicsEventhandler);
             APIFNC(removeMapGraphicsGroup);
             APIFNC(triggerMapGraphicsEvent);
+            FNC(unindexMapGraphicsGroup);
             APIFNC(registerMapControl);
             APIFNC(unregisterMapControl);
         };
 
         MODULE(Mutex) {
             dependency[] = {"CLib/Events"};
+            FNC(checkMutexDeadlines);
             FNC(clientInit);
+            APIFNC(getMutexStats);
+            FNC(grantNextMutexLease);
             APIFNC(mutex);
+            FNC(popMutexDeadline);
+            FNC(pushMutexDeadline);
+            FNC(queueMutexMessage);
+            APIFNC(releaseMutex);
+            APIFNC(renewMutex);
+            FNC(sendMutexGrants);
+            FNC(sendMutexMessage);
             FNC(serverInit);
         };
 
@@ -230,7 +267,9 @@ class CfgCLibModules {
             APIFNC(allVariables);
             APIFNC(createNamespace);
             APIFNC(deleteNamespace);
+            FNC(postInit);
             APIFNC(setVariable);
+            FNC(updateVariableCache);
         };
 
         MODULE(ObjectPooling) {
@@ -244,12 +283,19 @@ class CfgCLibModules {
             dependency[] = {"CLib/Events"};
             FNC(clientInit);
             APIFNC(dumpPerformanceInfo);
+            FNC(getProfilingReport);
+            FNC(init);
         };
 
         MODULE(PerFrame) {
             dependency[] = {"CLib/Namespaces"};
             APIFNC(addPerframeHandler);
+            FNC(benchmarkWait);
+            APIFNC(cancelWait);
             APIFNC(execNextFrame);
+            APIFNC(getProfileSlot);
+            FNC(heapPop);
+            FNC(heapPush);
             FNC(init);
             APIFNC(removePerframeHandler);
             APIFNC(skipFrames);
@@ -275,7 +321,7 @@ class CfgCLibModules {
         };
 
         MODULE(SimpleObjectFramework) {
-            dependency[] = {"CLib/Namespaces", "CLib/Events"};
+            dependency[] = {"CLib/Namespaces", "CLib/Events", "CLib/ConfigCaching"};
             APIFNC(createSimpleObjectComp);
             APIFNC(deleteSimpleObjectComp);
             FNC(init);
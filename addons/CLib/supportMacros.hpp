@@ -64,6 +64,22 @@
     #define RUNTIME(var) /*Disabled*/
 #endif
 
+// Sampled profiling that stays enabled in release builds, every call is counted but only every n-th call gets timed
+// The slot is a [calls, samples, total time, max time] array from CLib_fnc_getProfileSlot
+#define PROFILESTART(slot) \
+    private _CLib_profileSlot = slot; \
+    private _CLib_profileCalls = (_CLib_profileSlot select 0) + 1; \
+    _CLib_profileSlot set [0, _CLib_profileCalls]; \
+    private _CLib_profileStart = [-1, diag_tickTime] select ((_CLib_profileCalls - 1) mod CGVAR(profileSampleRate) == 0)
+
+#define PROFILEEND \
+    if (_CLib_profileStart >= 0) then { \
+        _CLib_profileStart = diag_tickTime - _CLib_profileStart; \
+        _CLib_profileSlot set [1, (_CLib_profileSlot select 1) + 1]; \
+        _CLib_profileSlot set [2, (_CLib_profileSlot select 2) + _CLib_profileStart]; \
+        _CLib_profileSlot set [3, (_CLib_profileSlot select 3) max _CLib_profileStart]; \
+    }
+
 #define ELSTRING(var1,var2) TRIPLE(DOUBLE(STR,PREFIX),var1,var2)
 #define LSTRING(var) ELSTRING(MODULE,var)
 
@@ -7,6 +7,7 @@ public class ArmaRequest
         public int TaskId { get; private set; }
         public string ExtensionName { get; private set; }
         public string ActionName { get; private set; }
+        public int Priority { get; private set; }
         public string Data { get; private set; }
 
         public static ArmaRequest Parse(string input)
@@ -16,7 +17,7 @@ public static ArmaRequest Parse(string input)
             int textEnd = input.IndexOf(ControlCharacter.ETX);
 
             string header = input.Substring(headerStart < 0 ? 0 : headerStart + 1, (textStart < 0 ? input.Length : textStart) - 1);
-            string[] headerValues = header.Split(new [] { ControlCharacter.US }, 3);
+            string[] headerValues = header.Split(new [] { ControlCharacter.US }, 4);
 
             var request = new ArmaRequest();
             int taskId;
@@ -25,6 +26,13 @@ public static ArmaRequest Parse(string input)
             request.TaskId = taskId;
             request.ExtensionName = headerValues[1].Trim();
             request.ActionName = headerValues[2].Trim();
+
+            // The priority is optional for backwards compatibility
+            int priority = 0;
+            if (headerValues.Length > 3 && !int.TryParse(headerValues[3], out priority))
+                throw new ArgumentException($"Invalid priority: {headerValues[3]}");
+            request.Priority = priority;
+
             request.Data = textStart < 0 ? "" : input.Substring(textStart + 1, textEnd - textStart - 1);
 
             return request;
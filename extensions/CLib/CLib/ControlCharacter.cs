@@ -9,6 +9,10 @@ public struct ControlCharacter
         public const char ENQ = '\x05';
         public const char ACK = '\x06';
 
+        public const char DC1 = '\x11';
+        public const char NAK = '\x15';
+        public const char CAN = '\x18';
+
         public const char RS = '\x1E';
         public const char US = '\x1F';
     }
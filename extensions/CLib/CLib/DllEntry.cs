@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.ComponentModel;
 using System.Diagnostics;
@@ -15,17 +16,27 @@ namespace CLib
 {
     public class DllEntry
     {
-        private static string _inputBuffer;
-        private static string _outputBuffer;
+        private static readonly StringBuilder InputBuffer = new StringBuilder();
+        private static readonly OutputCursor OutputBuffer = new OutputCursor();
         private static readonly Debugger Debugger;
         private static readonly Dictionary<string, string> AvailableExtensions = new Dictionary<string, string>();
-        private static readonly Dictionary<int, Task<string>> Tasks = new Dictionary<int, Task<string>>();
+        private static readonly ConcurrentDictionary<string, IntPtr> ModuleHandles = new ConcurrentDictionary<string, IntPtr>();
+        private static readonly ConcurrentDictionary<string, ExtensionAction> DispatchTable = new ConcurrentDictionary<string, ExtensionAction>();
+        private static readonly RequestScheduler Scheduler = new RequestScheduler();
+
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        public delegate int ExtensionCallback([MarshalAs(UnmanagedType.LPStr)] string name, [MarshalAs(UnmanagedType.LPStr)] string function, [MarshalAs(UnmanagedType.LPStr)] string data);
+        private static ExtensionCallback _callback;
+        private static volatile bool _callbackMode;
+        private static int _callbackSignaled;
 
         static DllEntry()
         {
             Debugger = new Debugger();
             Debugger.Log("Extension framework initializing");
 
+            Scheduler.TaskCompleted += SignalCompletedTasks;
+
             try
             {
                 DetectExtensions();
@@ -49,6 +60,16 @@ public static void RVExtensionVersion(StringBuilder output, int outputSize)
             output.Append(DllEntry.GetVersion());
         }
 
+#if WIN64
+        [DllExport("RVExtensionRegisterCallback")]
+#else
+        [DllExport("_RVExtensionRegisterCallback@4", CallingConvention.StdCall)]
+#endif
+        public static void RVExtensionRegisterCallback([MarshalAs(UnmanagedType.FunctionPtr)] ExtensionCallback callback)
+        {
+            _callback = callback;
+        }
+
 #if WIN64
         [DllExport("RVExtension")]
 #else
@@ -68,49 +89,36 @@ public static void RVExtension(StringBuilder output, int outputSize, [MarshalAs(
                 case "version":
                     output.Append(DllEntry.GetVersion());
                     break;
+                case "callback":
+                    // Completed tasks are signaled through the ExtensionCallback event instead of being polled
+                    _callbackMode = _callback != null;
+                    output.Append(_callbackMode ? ControlCharacter.ACK : ControlCharacter.NAK);
+                    break;
+                case "chunksize":
+                    // Size of the engine buffer in bytes, SQF derives the size of its input chunks from it
+                    output.Append(outputSize);
+                    break;
+                case "stats":
+                    output.Append(ControlCharacter.STX + "[" + string.Join(",", DispatchTable.Values) + "]" + ControlCharacter.EOT);
+                    break;
                 default:
                     switch (input[0])
                     {
                         case ControlCharacter.ACK:
-                            output.Append(DllEntry._outputBuffer);
-                            break;
+                            output.Append(OutputBuffer.Next(outputSize));
+                            return;
                         case ControlCharacter.ENQ:
-                            if (Tasks.Count == 0)
+                            Interlocked.Exchange(ref _callbackSignaled, 0);
+                            if (!Scheduler.HasCompletedTasks)
                                 break;
 
                             try
                             {
-                                var completedTasksIndices = new List<int>();
-                                foreach (var taskEntry in Tasks)
+                                RequestScheduler.ScheduledTask task;
+                                while ((task = Scheduler.DequeueCompleted()) != null)
                                 {
-                                    if (!taskEntry.Value.IsCompleted)
-                                        continue;
-
-                                    try
-                                    {
-                                        output.Append(ControlCharacter.SOH + taskEntry.Key.ToString() + ControlCharacter.STX + taskEntry.Value.Result);
-                                    } catch (Exception e) {
-                                        output.Append(ControlCharacter.SOH + taskEntry.Key.ToString() + ControlCharacter.STX);
-                                        if (e is AggregateException) 
-                                        {
-                                            ((AggregateException)e).Handle(x => 
-                                            {
-                                                output.Append(x.Message + "\n");
-                                                return true;
-                                            });
-                                        } 
-                                        else 
-                                        {
-                                            output.Append(e.Message);
-                                        }
-                                    }
-                                    Debugger.Log("Task result: " + taskEntry.Key);
-                                    completedTasksIndices.Add(taskEntry.Key);
-                                }
-
-                                foreach (int index in completedTasksIndices)
-                                {
-                                    Tasks.Remove(index);
+                                    output.Append(ControlCharacter.SOH + task.TaskId.ToString() + ControlCharacter.STX + task.Result);
+                                    Debugger.Log("Task result: " + task.TaskId);
                                 }
 
                                 output.Append(ControlCharacter.EOT);
@@ -121,13 +129,39 @@ public static void RVExtension(StringBuilder output, int outputSize, [MarshalAs(
                                 output.Append(e.Message);
                             }
                             break;
+                        case ControlCharacter.CAN:
+                            int cancelTaskId;
+                            if (int.TryParse(input.Substring(1), out cancelTaskId) && Scheduler.Cancel(cancelTaskId))
+                            {
+                                Debugger.Log("Task cancelled: " + cancelTaskId);
+                                output.Append(ControlCharacter.ACK);
+                            }
+                            else
+                            {
+                                output.Append(ControlCharacter.NAK);
+                            }
+                            break;
+                        case ControlCharacter.DC1:
+                            string[] workerLimit = input.Substring(1).Split(ControlCharacter.US);
+                            int workerCount;
+                            if (workerLimit.Length == 2 && int.TryParse(workerLimit[1], out workerCount))
+                            {
+                                Scheduler.SetWorkerLimit(workerLimit[0], workerCount);
+                                Debugger.Log($"Worker limit: {workerLimit[0]} {workerCount}");
+                                output.Append(ControlCharacter.ACK);
+                            }
+                            else
+                            {
+                                output.Append(ControlCharacter.NAK);
+                            }
+                            break;
                         default:
                             try
                             {
-                                _inputBuffer += input;
+                                InputBuffer.Append(input);
 
-                                if (_inputBuffer[_inputBuffer.Length - 1] == ControlCharacter.ETX)
-                                    output.Append(ExecuteRequest(ArmaRequest.Parse(_inputBuffer)));
+                                if (InputBuffer[InputBuffer.Length - 1] == ControlCharacter.ETX)
+                                    output.Append(ExecuteRequest(ArmaRequest.Parse(InputBuffer.ToString())));
                                 else
                                     output.Append(ControlCharacter.ACK);
                             }
@@ -140,18 +174,18 @@ public static void RVExtension(StringBuilder output, int outputSize, [MarshalAs(
                     break;
             }
 
-            List<byte> outputBytes = Encoding.Default.GetBytes(output.ToString()).ToList();
-            if (outputBytes.Count <= outputSize)
+            // Most outputs are small enough to skip the encoding
+            if (Encoding.Default.GetMaxByteCount(output.Length) <= outputSize)
                 return;
 
-            int outputSplitPosition = outputSize;
-            while ((outputBytes[outputSplitPosition - 1] & 0xC0) == 0x80)
-            {
-                outputSplitPosition--;
-            }
+            // Encode the output once, the remaining data is fetched in byte slices with ACK
+            byte[] outputBytes = Encoding.Default.GetBytes(output.ToString());
+            if (outputBytes.Length <= outputSize)
+                return;
 
-            DllEntry._outputBuffer = Encoding.Default.GetString(outputBytes.GetRange(outputSplitPosition, outputBytes.Count - outputSplitPosition).ToArray());
-            output = output.Remove(output.Length - DllEntry._outputBuffer.Length, DllEntry._outputBuffer.Length);
+            OutputBuffer.Reset(outputBytes);
+            output.Clear();
+            output.Append(OutputBuffer.Next(outputSize));
         }
 
         private static string GetVersion()
@@ -168,28 +202,64 @@ private static string GetVersion()
             return "0.0.0.0";
         }
 
-        private delegate string CLibFuncDelegate(string input);
         private static string ExecuteRequest(ArmaRequest request)
         {
-            _inputBuffer = "";
-
-            if (!AvailableExtensions.ContainsKey(request.ExtensionName))
-                throw new ArgumentException($"Extension is not valid: {request.ExtensionName}");
+            InputBuffer.Clear();
 
-            var function = FunctionLoader.LoadFunction<CLibFuncDelegate>(AvailableExtensions[request.ExtensionName], request.ActionName);
+            var action = GetAction(request.ExtensionName, request.ActionName);
 
             if (request.TaskId == -1)
             {
-                return ControlCharacter.STX + function(request.Data) + ControlCharacter.EOT;
+                return ControlCharacter.STX + action.Invoke(request.Data) + ControlCharacter.EOT;
             }
 
-            var task = Task.Run(() => function(request.Data));
-            if (Tasks.ContainsKey(request.TaskId))
-                Tasks.Remove(request.TaskId);
-            Tasks.Add(request.TaskId, task);
+            // Reject the request if the extension is saturated so SQF can retry it later
+            if (!Scheduler.Enqueue(new RequestScheduler.ScheduledTask(request.TaskId, request.Priority, request.Data, action)))
+                return (ControlCharacter.NAK).ToString();
+
             return (ControlCharacter.ACK).ToString();
         }
 
+        private static void SignalCompletedTasks()
+        {
+            // Only signal once until the completed tasks got fetched with ENQ
+            if (!_callbackMode || Interlocked.Exchange(ref _callbackSignaled, 1) == 1)
+                return;
+
+            try
+            {
+                // The engine returns -1 if its callback queue is full
+                if (_callback("CLib", "ENQ", "") >= 0)
+                    return;
+            }
+            catch (Exception e)
+            {
+                Debugger.Log(e);
+            }
+
+            Interlocked.Exchange(ref _callbackSignaled, 0);
+            Task.Delay(50).ContinueWith(task => SignalCompletedTasks());
+        }
+
+        private static ExtensionAction GetAction(string extensionName, string actionName)
+        {
+            ExtensionAction action;
+            if (DispatchTable.TryGetValue(ExtensionAction.Key(extensionName, actionName), out action))
+                return action;
+
+            string extensionPath;
+            if (!AvailableExtensions.TryGetValue(extensionName, out extensionPath))
+                throw new ArgumentException($"Extension is not valid: {extensionName}");
+
+            // Module handles and delegates are resolved once and kept for the lifetime of the process
+            var hModule = ModuleHandles.GetOrAdd(extensionName, name => FunctionLoader.LoadModule(extensionPath));
+            var function = FunctionLoader.LoadFunction<ExtensionAction.CLibFuncDelegate>(hModule, actionName);
+
+            action = DispatchTable.GetOrAdd(ExtensionAction.Key(extensionName, actionName), new ExtensionAction(extensionName, actionName, function));
+            Debugger.Log($"Resolved: {extensionName}.{actionName}");
+            return action;
+        }
+
         private static void DetectExtensions()
         {
             Debugger.Log($"Current directory is: {Environment.CurrentDirectory}");
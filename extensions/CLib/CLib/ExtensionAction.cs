@@ -0,0 +1,65 @@
+using System.Diagnostics;
+using System.Globalization;
+using System.Threading;
+
+namespace CLib
+{
+    public class ExtensionAction
+    {
+        public delegate string CLibFuncDelegate(string input);
+
+        public string ExtensionName { get; }
+        public string ActionName { get; }
+
+        private readonly CLibFuncDelegate _function;
+        private long _callCount;
+        private long _totalTicks;
+        private long _maxTicks;
+
+        public ExtensionAction(string extensionName, string actionName, CLibFuncDelegate function)
+        {
+            ExtensionName = extensionName;
+            ActionName = actionName;
+            _function = function;
+        }
+
+        public static string Key(string extensionName, string actionName)
+        {
+            return extensionName + ControlCharacter.US + actionName;
+        }
+
+        public string Invoke(string input)
+        {
+            long startTicks = Stopwatch.GetTimestamp();
+            try
+            {
+                return _function(input);
+            }
+            finally
+            {
+                long elapsedTicks = Stopwatch.GetTimestamp() - startTicks;
+                Interlocked.Increment(ref _callCount);
+                Interlocked.Add(ref _totalTicks, elapsedTicks);
+
+                long maxTicks = Interlocked.Read(ref _maxTicks);
+                while (elapsedTicks > maxTicks)
+                {
+                    long previousMaxTicks = Interlocked.CompareExchange(ref _maxTicks, elapsedTicks, maxTicks);
+                    if (previousMaxTicks == maxTicks)
+                        break;
+
+                    maxTicks = previousMaxTicks;
+                }
+            }
+        }
+
+        // Formatted as a SQF array: [extension, action, calls, total ms, max ms]
+        public override string ToString()
+        {
+            double ticksToMs = 1000.0 / Stopwatch.Frequency;
+            return string.Format(CultureInfo.InvariantCulture, "[\"{0}\",\"{1}\",{2},{3:0.###},{4:0.###}]",
+                ExtensionName, ActionName, Interlocked.Read(ref _callCount),
+                Interlocked.Read(ref _totalTicks) * ticksToMs, Interlocked.Read(ref _maxTicks) * ticksToMs);
+        }
+    }
+}
@@ -325,11 +325,21 @@ public static List<string> ExportTable(string dllPath)
         }
 
         public static T LoadFunction<T>(string dllPath, string functionName)
+        {
+            return LoadFunction<T>(LoadModule(dllPath), functionName);
+        }
+
+        public static IntPtr LoadModule(string dllPath)
         {
             var hModule = LoadLibraryEx(dllPath, IntPtr.Zero, 0);
             if (hModule == IntPtr.Zero)
                 throw new ArgumentException($"Dll not found: {dllPath} - Error code: {GetLastError()}");
 
+            return hModule;
+        }
+
+        public static T LoadFunction<T>(IntPtr hModule, string functionName)
+        {
             var functionAddress = GetProcAddress(hModule, functionName);
             if (functionAddress == IntPtr.Zero)
                 throw new ArgumentException($"Function not found: {functionName} - Error code: {GetLastError()}");
@@ -0,0 +1,45 @@
+using System;
+using System.Text;
+
+namespace CLib
+{
+    // Holds the encoded remainder of a result which did not fit into the output buffer and hands it out chunk by chunk
+    public class OutputCursor
+    {
+        private byte[] _bytes = new byte[0];
+        private int _position;
+
+        public bool IsEmpty => _position >= _bytes.Length;
+
+        public void Reset(byte[] bytes)
+        {
+            _bytes = bytes;
+            _position = 0;
+        }
+
+        public string Next(int chunkSize)
+        {
+            int length = Math.Min(chunkSize, _bytes.Length - _position);
+
+            // Never split a UTF-8 character, the next chunk has to start on a lead byte
+            if (_position + length < _bytes.Length)
+            {
+                int splitLength = length;
+                while (splitLength > 0 && (_bytes[_position + splitLength] & 0xC0) == 0x80)
+                {
+                    splitLength--;
+                }
+
+                if (splitLength > 0)
+                    length = splitLength;
+            }
+
+            string chunk = Encoding.Default.GetString(_bytes, _position, length);
+            _position += length;
+            if (IsEmpty)
+                Reset(new byte[0]);
+
+            return chunk;
+        }
+    }
+}
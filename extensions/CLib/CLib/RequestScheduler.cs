@@ -0,0 +1,175 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.Linq;
+using System.Threading.Tasks;
+
+namespace CLib
+{
+    public class RequestScheduler
+    {
+        public const int DefaultWorkerLimit = 4;
+        public const int MaxQueueLength = 1024;
+
+        public class ScheduledTask
+        {
+            public int TaskId { get; }
+            public int Priority { get; }
+            public string Data { get; }
+            public ExtensionAction Action { get; }
+            public string Result { get; set; }
+            public volatile bool Cancelled;
+
+            public ScheduledTask(int taskId, int priority, string data, ExtensionAction action)
+            {
+                TaskId = taskId;
+                Priority = priority;
+                Data = data;
+                Action = action;
+            }
+        }
+
+        private class ExtensionQueue
+        {
+            // Sorted by descending priority, tasks with the same priority run in order of arrival
+            public readonly SortedDictionary<int, Queue<ScheduledTask>> Pending = new SortedDictionary<int, Queue<ScheduledTask>>(Comparer<int>.Create((a, b) => b.CompareTo(a)));
+            public int PendingCount;
+            public int RunningWorkers;
+            public int WorkerLimit = DefaultWorkerLimit;
+        }
+
+        private readonly ConcurrentDictionary<string, ExtensionQueue> _queues = new ConcurrentDictionary<string, ExtensionQueue>();
+        private readonly ConcurrentDictionary<int, ScheduledTask> _tasks = new ConcurrentDictionary<int, ScheduledTask>();
+        private readonly ConcurrentQueue<ScheduledTask> _completedTasks = new ConcurrentQueue<ScheduledTask>();
+
+        public bool HasCompletedTasks => !_completedTasks.IsEmpty;
+
+        public event Action TaskCompleted;
+
+        public void SetWorkerLimit(string extensionName, int workerLimit)
+        {
+            var queue = _queues.GetOrAdd(extensionName, name => new ExtensionQueue());
+            lock (queue)
+            {
+                queue.WorkerLimit = Math.Max(1, workerLimit);
+            }
+
+            StartWorkers(queue);
+        }
+
+        // Returns false if the queue of the extension is full
+        public bool Enqueue(ScheduledTask task)
+        {
+            var queue = _queues.GetOrAdd(task.Action.ExtensionName, name => new ExtensionQueue());
+            lock (queue)
+            {
+                if (queue.PendingCount >= MaxQueueLength)
+                    return false;
+
+                ScheduledTask previousTask;
+                if (_tasks.TryRemove(task.TaskId, out previousTask))
+                    previousTask.Cancelled = true;
+                _tasks[task.TaskId] = task;
+
+                Queue<ScheduledTask> priorityQueue;
+                if (!queue.Pending.TryGetValue(task.Priority, out priorityQueue))
+                {
+                    priorityQueue = new Queue<ScheduledTask>();
+                    queue.Pending.Add(task.Priority, priorityQueue);
+                }
+
+                priorityQueue.Enqueue(task);
+                queue.PendingCount++;
+            }
+
+            StartWorkers(queue);
+            return true;
+        }
+
+        // Returns false if the task is unknown or its result was already fetched
+        public bool Cancel(int taskId)
+        {
+            ScheduledTask task;
+            if (!_tasks.TryRemove(taskId, out task))
+                return false;
+
+            task.Cancelled = true;
+            return true;
+        }
+
+        // Returns the next completed task which was not cancelled or null if there is none
+        public ScheduledTask DequeueCompleted()
+        {
+            ScheduledTask task;
+            while (_completedTasks.TryDequeue(out task))
+            {
+                // Only remove the task if its id was not reused by a newer request in the meantime
+                if (((ICollection<KeyValuePair<int, ScheduledTask>>)_tasks).Remove(new KeyValuePair<int, ScheduledTask>(task.TaskId, task)))
+                    return task;
+            }
+
+            return null;
+        }
+
+        private void StartWorkers(ExtensionQueue queue)
+        {
+            lock (queue)
+            {
+                while (queue.RunningWorkers < queue.WorkerLimit && queue.RunningWorkers < queue.PendingCount)
+                {
+                    queue.RunningWorkers++;
+                    Task.Run(() => Work(queue));
+                }
+            }
+        }
+
+        private void Work(ExtensionQueue queue)
+        {
+            while (true)
+            {
+                ScheduledTask task;
+                lock (queue)
+                {
+                    task = queue.RunningWorkers > queue.WorkerLimit ? null : DequeueNext(queue);
+                    if (task == null)
+                    {
+                        queue.RunningWorkers--;
+                        return;
+                    }
+                }
+
+                try
+                {
+                    task.Result = task.Action.Invoke(task.Data);
+                }
+                catch (Exception e)
+                {
+                    task.Result = e.Message;
+                }
+
+                if (task.Cancelled)
+                    continue;
+
+                _completedTasks.Enqueue(task);
+                TaskCompleted?.Invoke();
+            }
+        }
+
+        private static ScheduledTask DequeueNext(ExtensionQueue queue)
+        {
+            while (queue.Pending.Count > 0)
+            {
+                var priorityQueue = queue.Pending.First();
+                var task = priorityQueue.Value.Dequeue();
+                if (priorityQueue.Value.Count == 0)
+                    queue.Pending.Remove(priorityQueue.Key);
+
+                queue.PendingCount--;
+                if (!task.Cancelled)
+                    return task;
+            }
+
+            return null;
+        }
+    }
+}
@@ -12,6 +12,8 @@ public class DllEntry
         private const int WindowSize = 1 << 11;
         private const int MinMatchLength = 2;
         private const uint MaxMatchLength = (1 << 4) - MinMatchLength;
+        private const int TrigramLength = MinMatchLength + 1;
+        private const int HashSize = 1 << 15;
 
 #if WIN64
         [DllExport("RVExtensionVersion")]
@@ -53,11 +55,24 @@ private static string GetVersion()
         [DllExport("Compress")]
         public static string Compress(string input)
         {
-            var output = new StringBuilder();
-            var writeBuffer = new List<char>();
+            if (input.Length <= MinMatchLength)
+                return input;
+
+            var output = new StringBuilder(input.Length);
+            var writeBuffer = new List<char>(2 * 7);
             int symbolsWritten = 0;
             int encodeFlag = 1;
 
+            // Hash chains over all trigrams in the window. HashHead holds the most recent position of a trigram hash,
+            // HashPrevious links every position to the previous one with the same hash.
+            var hashHead = new int[HashSize];
+            var hashPrevious = new int[input.Length];
+            for (int i = 0; i < HashSize; i++)
+            {
+                hashHead[i] = -1;
+            }
+            int hashedUntil = 0;
+
             output.Append(input.Substring(0, MinMatchLength));
 
             for (int inputPosition = MinMatchLength; inputPosition < input.Length; inputPosition++)
@@ -68,19 +83,13 @@ public static string Compress(string input)
                 int bestMatchLength = 0;
                 int bestMatchOffset = 0;
 
-                for (int windowPosition = 1; windowPosition <= searchSteps; windowPosition++)
+                // Offsets below the trigram length can wrap around inside the match loop so they get checked directly
+                for (int windowPosition = 1; windowPosition < TrigramLength && windowPosition <= searchSteps; windowPosition++)
                 {
                     if (currentChar != input[inputPosition - windowPosition])
                         continue;
 
-                    int currentMatchLength = 1;
-                    while (inputPosition + currentMatchLength < input.Length && input[inputPosition - searchSteps + ((searchSteps - windowPosition + currentMatchLength) % searchSteps)]
-                        == input[inputPosition + currentMatchLength]
-                        && currentMatchLength < MaxMatchLength)
-                    {
-                        currentMatchLength++;
-                    }
-
+                    int currentMatchLength = MatchLength(input, inputPosition, searchSteps, windowPosition);
                     if (currentMatchLength <= bestMatchLength)
                         continue;
 
@@ -88,6 +97,34 @@ public static string Compress(string input)
                     bestMatchOffset = windowPosition;
                 }
 
+                // Every longer match has to start with the same trigram as the current position
+                for (; hashedUntil <= inputPosition - TrigramLength; hashedUntil++)
+                {
+                    int hash = TrigramHash(input, hashedUntil);
+                    hashPrevious[hashedUntil] = hashHead[hash];
+                    hashHead[hash] = hashedUntil;
+                }
+
+                if (inputPosition + TrigramLength <= input.Length)
+                {
+                    int candidate = hashHead[TrigramHash(input, inputPosition)];
+                    while (candidate >= 0 && inputPosition - candidate <= searchSteps && bestMatchLength < MaxMatchLength)
+                    {
+                        int windowPosition = inputPosition - candidate;
+                        if (currentChar == input[candidate])
+                        {
+                            int currentMatchLength = MatchLength(input, inputPosition, searchSteps, windowPosition);
+                            if (currentMatchLength > bestMatchLength)
+                            {
+                                bestMatchLength = currentMatchLength;
+                                bestMatchOffset = windowPosition;
+                            }
+                        }
+
+                        candidate = hashPrevious[candidate];
+                    }
+                }
+
                 symbolsWritten++;
 
                 if (bestMatchLength > MinMatchLength)
@@ -121,5 +158,70 @@ public static string Compress(string input)
 
             return Encoding.Default.GetString(Encoding.Convert(Encoding.Unicode, Encoding.UTF8, Encoding.Unicode.GetBytes(output.ToString())));
         }
+
+        [DllExport("Decompress")]
+        public static string Decompress(string input)
+        {
+            input = Encoding.UTF8.GetString(Encoding.Default.GetBytes(input));
+            if (input.Length <= MinMatchLength)
+                return input;
+
+            var output = new StringBuilder(input.Length * 2);
+            output.Append(input, 0, MinMatchLength);
+
+            int inputPosition = MinMatchLength;
+            while (inputPosition < input.Length)
+            {
+                int encodeFlag = input[inputPosition++];
+
+                for (int symbol = 1; symbol <= 7 && inputPosition < input.Length; symbol++)
+                {
+                    if ((encodeFlag & (1 << symbol)) == 0)
+                    {
+                        output.Append(input[inputPosition++]);
+                        continue;
+                    }
+
+                    if (inputPosition + 1 >= input.Length)
+                        throw new ArgumentException($"Truncated match at position {inputPosition}");
+
+                    int high = input[inputPosition++];
+                    int low = input[inputPosition++];
+                    int windowPosition = ((high >> 1) << 4) | (low >> 4);
+                    int matchLength = (low & 0xF) + MinMatchLength;
+
+                    int outputPosition = output.Length;
+                    int searchSteps = Math.Min(WindowSize, outputPosition);
+                    if (windowPosition == 0 || windowPosition > searchSteps)
+                        throw new ArgumentException($"Invalid match offset {windowPosition} at position {inputPosition - 2}");
+
+                    // Mirrors the index calculation of the match loop in Compress
+                    for (int i = 0; i < matchLength; i++)
+                    {
+                        output.Append(output[outputPosition - searchSteps + ((searchSteps - windowPosition + i) % searchSteps)]);
+                    }
+                }
+            }
+
+            return output.ToString();
+        }
+
+        private static int MatchLength(string input, int inputPosition, int searchSteps, int windowPosition)
+        {
+            int currentMatchLength = 1;
+            while (inputPosition + currentMatchLength < input.Length && input[inputPosition - searchSteps + ((searchSteps - windowPosition + currentMatchLength) % searchSteps)]
+                == input[inputPosition + currentMatchLength]
+                && currentMatchLength < MaxMatchLength)
+            {
+                currentMatchLength++;
+            }
+
+            return currentMatchLength;
+        }
+
+        private static int TrigramHash(string input, int position)
+        {
+            return ((input[position] << 10) ^ (input[position + 1] << 5) ^ input[position + 2]) & (HashSize - 1);
+        }
     }
 }
@@ -13,17 +13,58 @@ namespace CLibDatabase
 {
     public class DllEntry
     {
-        private static string loadedDatabase = "";
+        private static LogStore loadedDatabase;
 
         private static string databaseFolder =
             Path.Combine(Environment.GetFolderPath(Environment.SpecialFolder.ApplicationData), "CLibDatabase");
 
-        private static Dictionary<string, string> database = new Dictionary<string, string>();
+        private static readonly Dictionary<string, LogStore> databases = new Dictionary<string, LogStore>();
 
         static DllEntry()
         {
             if (!Directory.Exists(databaseFolder))
                 Directory.CreateDirectory(databaseFolder);
+
+            AppDomain.CurrentDomain.ProcessExit += (sender, args) => CloseDatabases();
+        }
+
+        private static LogStore Database
+        {
+            get
+            {
+                lock (databases)
+                {
+                    if (loadedDatabase == null)
+                        loadedDatabase = OpenDatabase("");
+                    return loadedDatabase;
+                }
+            }
+        }
+
+        private static LogStore OpenDatabase(string filename)
+        {
+            LogStore store;
+            if (!databases.TryGetValue(filename, out store))
+            {
+                store = new LogStore(databaseFolder, filename);
+                databases.Add(filename, store);
+            }
+
+            return store;
+        }
+
+        private static void CloseDatabases()
+        {
+            lock (databases)
+            {
+                foreach (LogStore store in databases.Values)
+                {
+                    store.Dispose();
+                }
+
+                databases.Clear();
+                loadedDatabase = null;
+            }
         }
 
 #if WIN64
@@ -78,65 +119,162 @@ public static string SetExportPath(string path)
         [DllExport("KeyExists")]
         public static string KeyExists(string key)
         {
-            return database.ContainsKey(key).ToString();
+            return Database.ContainsKey(key).ToString();
         }
 
         [DllExport("Get")]
         public static string Get(string key)
         {
-            if (!database.ContainsKey(key))
+            string value;
+            if (!Database.TryGetValue(key, out value))
                 return "ERROR";
-            return database[key];
+            return value;
         }
 
         [DllExport("Set")]
         public static string Set(string input)
         {
-            string[] keyAndValue = input.Split(new[] {"~>"}, StringSplitOptions.RemoveEmptyEntries);
-            if (!database.ContainsKey(keyAndValue[0]))
-                database.Add(keyAndValue[0], keyAndValue[1]);
-            else
-                database[keyAndValue[0]] = keyAndValue[1];
+            // Only the first separator splits, the value may contain it as well
+            string[] keyAndValue = input.Split(new[] {"~>"}, 2, StringSplitOptions.None);
+            Database.Set(keyAndValue[0], keyAndValue[1]);
 
             return "true";
         }
 
-        [DllExport("Load")]
-        public static string Load(string filename)
+        [DllExport("Delete")]
+        public static string Delete(string key)
+        {
+            return Database.Delete(key).ToString();
+        }
+
+        // Executes many operations in one call. Every operation is a letter followed by its fields,
+        // every field is prefixed with its length in characters: S<key><value>, G<key>, E<key>, D<key>
+        // e.g. "S6:player5:valueG6:player" returns [true,"value"] as a SQF array, missing keys return false
+        [DllExport("Batch")]
+        public static string Batch(string input)
         {
-            if (loadedDatabase == filename)
-                return "true";
-            
-            using (FileStream fs = File.OpenRead(Path.Combine(databaseFolder, filename + ".clibdata")))
+            LogStore store = Database;
+            var results = new List<string>();
+            int position = 0;
+            while (position < input.Length)
             {
-                GZipStream cmp = new GZipStream(fs, CompressionMode.Decompress);
-                using (BinaryReader reader = new BinaryReader(cmp))
+                char operation = input[position++];
+                string key = ReadField(input, ref position);
+                string value;
+                switch (operation)
                 {
-                    int count = reader.ReadInt32();
-                    database = new Dictionary<string, string>(count);
-                    for (int i = 0; i < count; i++)
-                    {
-                        string key = reader.ReadString();
-                        string value = reader.ReadString();
-                        database.Add(key, value);
-                    }
+                    case 'S':
+                        store.Set(key, ReadField(input, ref position));
+                        results.Add("true");
+                        break;
+                    case 'G':
+                        results.Add(store.TryGetValue(key, out value) ? QuoteString(value) : "false");
+                        break;
+                    case 'E':
+                        results.Add(store.ContainsKey(key) ? "true" : "false");
+                        break;
+                    case 'D':
+                        results.Add(store.Delete(key) ? "true" : "false");
+                        break;
+                    default:
+                        throw new ArgumentException($"Invalid batch operation: {operation}");
                 }
             }
 
-            loadedDatabase = filename;
+            return "[" + string.Join(",", results) + "]";
+        }
+
+        // Returns all entries whose key starts with the prefix as [[key, value], ...] in ordinal order
+        // Input: <prefix>[<limit>]
+        [DllExport("Scan")]
+        public static string Scan(string input)
+        {
+            int position = 0;
+            string prefix = ReadField(input, ref position);
+            int limit = position < input.Length ? int.Parse(ReadField(input, ref position)) : int.MaxValue;
+
+            return FormatEntries(Database.Scan(prefix, limit));
+        }
+
+        // Returns all entries with from <= key < to as [[key, value], ...] in ordinal order, an empty bound is open
+        // Input: <from><to>[<limit>]
+        [DllExport("Range")]
+        public static string Range(string input)
+        {
+            int position = 0;
+            string from = ReadField(input, ref position);
+            string to = ReadField(input, ref position);
+            int limit = position < input.Length ? int.Parse(ReadField(input, ref position)) : int.MaxValue;
+
+            return FormatEntries(Database.Range(from == "" ? null : from, to == "" ? null : to, limit));
+        }
+
+        // Reads a field in the format <length>:<text>, the length is the UTF-8 byte count that SQF count returns.
+        // The engine passes the UTF-8 bytes as an ANSI string, so every byte is one character of the input
+        private static string ReadField(string input, ref int position)
+        {
+            int separator = input.IndexOf(':', position);
+            int length;
+            if (separator < 0 || !int.TryParse(input.Substring(position, separator - position), out length) || length < 0)
+                throw new ArgumentException($"Invalid field at position {position}");
+
+            int start = separator + 1;
+            if (start + length > input.Length)
+                throw new ArgumentException($"Field at position {position} is too short");
+
+            position = start + length;
+            return input.Substring(start, length);
+        }
+
+        private static string QuoteString(string value)
+        {
+            return "\"" + value.Replace("\"", "\"\"") + "\"";
+        }
+
+        private static string FormatEntries(List<KeyValuePair<string, string>> entries)
+        {
+            var output = new StringBuilder("[");
+            foreach (KeyValuePair<string, string> entry in entries)
+            {
+                if (output.Length > 1)
+                    output.Append(',');
+                output.Append('[').Append(QuoteString(entry.Key)).Append(',').Append(QuoteString(entry.Value)).Append(']');
+            }
+
+            return output.Append(']').ToString();
+        }
+
+        // Databases stay open once they are loaded, loading switches the database the other functions work on
+        [DllExport("Load")]
+        public static string Load(string filename)
+        {
+            lock (databases)
+            {
+                loadedDatabase = OpenDatabase(filename);
+            }
+
             return "true";
         }
 
+        // Changes are written to the log of the database when they happen, saving only has to make sure they reached the disk
         [DllExport("Save")]
         public static string Save(string filename)
         {
+            LogStore store = Database;
+            if (store.Name == filename)
+            {
+                store.Flush();
+                return $"File Exported to {store.CheckpointPath}";
+            }
+
             string path = Path.Combine(databaseFolder, filename + ".clibdata");
-            using (FileStream fs = File.OpenWrite(path))
+            using (FileStream fs = File.Create(path))
             {
                 GZipStream dcmp = new GZipStream(fs, CompressionLevel.Optimal);
 
                 using (BinaryWriter writer = new BinaryWriter(dcmp))
                 {
+                    Dictionary<string, string> database = store.Snapshot();
                     writer.Write(database.Count);
                     foreach (KeyValuePair<string, string> pair in database)
                     {
@@ -151,28 +289,30 @@ public static string Save(string filename)
         private static JSONNode ConvertToJson()
         {
             JSONNode json = new JSONObject();
-            foreach (KeyValuePair<string, string> item in database) json.Add(item.Key, item.Value);
+            foreach (KeyValuePair<string, string> item in Database.Snapshot()) json.Add(item.Key, item.Value);
             return json;
         }
 
         private static void ConvertToDictionary(JSONNode json)
         {
-            database.Clear();
+            var database = new Dictionary<string, string>();
             foreach (KeyValuePair<string, JSONNode> item in json.Linq) database.Add(item.Key, item.Value.Value);
+            Database.ReplaceAll(database);
         }
 
         private static void ConvertToDictionary(XContainer xml)
         {
-            database.Clear();
+            var database = new Dictionary<string, string>();
             foreach (XElement item in xml.Elements())
             {
                 database.Add(item.Name.LocalName, item.Value);
             }
+            Database.ReplaceAll(database);
         }
         private static XDocument ConvertToXML()
         {
             XDocument xml = new XDocument();
-            foreach (KeyValuePair<string, string> item in database)
+            foreach (KeyValuePair<string, string> item in Database.Snapshot())
             {
                 xml.Add(item.Key, new JSONString(item.Value));
             }
@@ -232,10 +372,5 @@ public static string ImportXml(string filePath)
         }
 
         #endregion Import/Export
-
-        ~DllEntry()
-        {
-            Save(loadedDatabase);
-        }
     }
 }
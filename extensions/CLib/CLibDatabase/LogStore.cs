@@ -0,0 +1,401 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.IO.Compression;
+using System.Linq;
+using System.Text;
+using System.Threading.Tasks;
+
+namespace CLibDatabase
+{
+    // Database which appends every change as a record to a write-ahead log instead of rewriting the whole file.
+    // The log is split into segments. Closed segments get merged into the checkpoint file in the background.
+    //
+    // <name>.clibdata            Checkpoint, same format as before followed by the number of the last merged segment
+    // <name>.<number>.clibwal    Log segments, records are [int length][payload][int checksum]
+    public class LogStore : IDisposable
+    {
+        private const long SegmentSize = 4 << 20;
+        private const byte SetRecord = 1;
+        private const byte DeleteRecord = 2;
+
+        public string Name { get; }
+        public string CheckpointPath => Path.Combine(_folder, Name + ".clibdata");
+
+        private readonly string _folder;
+        private readonly object _lock = new object();
+        private Dictionary<string, string> _data = new Dictionary<string, string>();
+        private SortedSet<string> _keys = new SortedSet<string>(StringComparer.Ordinal);
+        private FileStream _segment;
+        private int _segmentNumber;
+        private Task _compaction = Task.FromResult(0);
+
+        public LogStore(string folder, string name)
+        {
+            _folder = folder;
+            Name = name;
+
+            int checkpointSegment = ReadCheckpoint();
+
+            var segments = GetSegments().ToList();
+            foreach (var segment in segments)
+            {
+                if (segment.Key <= checkpointSegment)
+                {
+                    // Left over from an interrupted compaction
+                    File.Delete(segment.Value);
+                    continue;
+                }
+
+                Replay(segment.Value, segment.Key == segments[segments.Count - 1].Key);
+                _segmentNumber = segment.Key;
+            }
+
+            _segmentNumber = Math.Max(_segmentNumber, checkpointSegment);
+            OpenSegment(_segmentNumber + 1);
+        }
+
+        public bool ContainsKey(string key)
+        {
+            lock (_lock)
+            {
+                return _data.ContainsKey(key);
+            }
+        }
+
+        public bool TryGetValue(string key, out string value)
+        {
+            lock (_lock)
+            {
+                return _data.TryGetValue(key, out value);
+            }
+        }
+
+        public void Set(string key, string value)
+        {
+            lock (_lock)
+            {
+                Append(SetRecord, key, value);
+                SetValue(key, value);
+            }
+        }
+
+        public bool Delete(string key)
+        {
+            lock (_lock)
+            {
+                if (!_data.ContainsKey(key))
+                    return false;
+
+                Append(DeleteRecord, key, null);
+                RemoveValue(key);
+                return true;
+            }
+        }
+
+        // Returns all entries with from <= key < to in ordinal order, a null bound is open
+        public List<KeyValuePair<string, string>> Range(string from, string to, int limit)
+        {
+            var entries = new List<KeyValuePair<string, string>>();
+            lock (_lock)
+            {
+                if (_keys.Count == 0 || (from != null && to != null && string.CompareOrdinal(from, to) >= 0))
+                    return entries;
+
+                string lowerBound = from ?? _keys.Min;
+                string upperBound = to ?? _keys.Max;
+                if (string.CompareOrdinal(lowerBound, upperBound) > 0)
+                    return entries;
+
+                foreach (string key in _keys.GetViewBetween(lowerBound, upperBound))
+                {
+                    if (entries.Count >= limit)
+                        break;
+                    if (to != null && key == to)
+                        continue;
+
+                    entries.Add(new KeyValuePair<string, string>(key, _data[key]));
+                }
+            }
+
+            return entries;
+        }
+
+        public List<KeyValuePair<string, string>> Scan(string prefix, int limit)
+        {
+            // The first string after all keys starting with the prefix
+            string end = prefix.TrimEnd(char.MaxValue);
+            end = end.Length == 0 ? null : end.Substring(0, end.Length - 1) + (char)(end[end.Length - 1] + 1);
+
+            return Range(prefix, end, limit);
+        }
+
+        public Dictionary<string, string> Snapshot()
+        {
+            lock (_lock)
+            {
+                return new Dictionary<string, string>(_data);
+            }
+        }
+
+        // Replaces the whole content, used by the imports
+        public void ReplaceAll(Dictionary<string, string> data)
+        {
+            lock (_lock)
+            {
+                _compaction.Wait();
+                _data = new Dictionary<string, string>(data);
+                _keys = new SortedSet<string>(_data.Keys, StringComparer.Ordinal);
+                int mergedSegment = RotateSegment();
+                WriteCheckpoint(_data, mergedSegment);
+                DeleteSegments(mergedSegment);
+            }
+        }
+
+        // Makes sure every record reached the disk
+        public void Flush()
+        {
+            lock (_lock)
+            {
+                _segment.Flush(true);
+            }
+        }
+
+        public void Dispose()
+        {
+            lock (_lock)
+            {
+                _compaction.Wait();
+
+                // Leave a complete checkpoint behind so external tools see the current state
+                _segment.Dispose();
+                WriteCheckpoint(_data, _segmentNumber);
+                DeleteSegments(_segmentNumber);
+            }
+        }
+
+        private void Append(byte type, string key, string value)
+        {
+            byte[] payload;
+            using (var stream = new MemoryStream())
+            using (var writer = new BinaryWriter(stream, Encoding.UTF8))
+            {
+                writer.Write(type);
+                writer.Write(key);
+                if (type == SetRecord)
+                    writer.Write(value);
+                writer.Flush();
+                payload = stream.ToArray();
+            }
+
+            var record = new byte[payload.Length + 8];
+            BitConverter.GetBytes(payload.Length).CopyTo(record, 0);
+            payload.CopyTo(record, 4);
+            BitConverter.GetBytes(Checksum(payload, payload.Length)).CopyTo(record, payload.Length + 4);
+
+            _segment.Write(record, 0, record.Length);
+            _segment.Flush();
+
+            if (_segment.Length >= SegmentSize)
+                StartCompaction();
+        }
+
+        private void StartCompaction()
+        {
+            if (!_compaction.IsCompleted)
+                return;
+
+            int mergedSegment = RotateSegment();
+            var snapshot = new Dictionary<string, string>(_data);
+            _compaction = Task.Run(() =>
+            {
+                WriteCheckpoint(snapshot, mergedSegment);
+                DeleteSegments(mergedSegment);
+            });
+        }
+
+        // Closes the current segment and returns its number
+        private int RotateSegment()
+        {
+            int closedSegment = _segmentNumber;
+            _segment.Dispose();
+            OpenSegment(closedSegment + 1);
+            return closedSegment;
+        }
+
+        private void OpenSegment(int number)
+        {
+            _segmentNumber = number;
+            _segment = new FileStream(SegmentPath(number), FileMode.Append, FileAccess.Write, FileShare.Read);
+        }
+
+        private string SegmentPath(int number)
+        {
+            return Path.Combine(_folder, $"{Name}.{number:D8}.clibwal");
+        }
+
+        private IEnumerable<KeyValuePair<int, string>> GetSegments()
+        {
+            var segments = new List<KeyValuePair<int, string>>();
+            foreach (string path in Directory.GetFiles(_folder, Name + ".*.clibwal"))
+            {
+                string number = Path.GetFileNameWithoutExtension(path).Substring(Name.Length + 1);
+                int segmentNumber;
+                if (int.TryParse(number, out segmentNumber))
+                    segments.Add(new KeyValuePair<int, string>(segmentNumber, path));
+            }
+
+            return segments.OrderBy(segment => segment.Key);
+        }
+
+        private void DeleteSegments(int lastSegment)
+        {
+            foreach (var segment in GetSegments())
+            {
+                if (segment.Key <= lastSegment)
+                    File.Delete(segment.Value);
+            }
+        }
+
+        private int ReadCheckpoint()
+        {
+            if (!File.Exists(CheckpointPath))
+                return 0;
+
+            using (FileStream fs = File.OpenRead(CheckpointPath))
+            {
+                GZipStream cmp = new GZipStream(fs, CompressionMode.Decompress);
+                using (BinaryReader reader = new BinaryReader(cmp))
+                {
+                    int count = reader.ReadInt32();
+                    _data = new Dictionary<string, string>(count);
+                    for (int i = 0; i < count; i++)
+                    {
+                        string key = reader.ReadString();
+                        string value = reader.ReadString();
+                        SetValue(key, value);
+                    }
+
+                    // Files written before the log or by the editor have no segment number
+                    try
+                    {
+                        return reader.ReadInt32();
+                    }
+                    catch (EndOfStreamException)
+                    {
+                        return 0;
+                    }
+                }
+            }
+        }
+
+        private void WriteCheckpoint(Dictionary<string, string> data, int mergedSegment)
+        {
+            string temporaryPath = CheckpointPath + ".tmp";
+            using (FileStream fs = File.Create(temporaryPath))
+            {
+                GZipStream dcmp = new GZipStream(fs, CompressionLevel.Optimal);
+
+                using (BinaryWriter writer = new BinaryWriter(dcmp))
+                {
+                    writer.Write(data.Count);
+                    foreach (KeyValuePair<string, string> pair in data)
+                    {
+                        writer.Write(pair.Key);
+                        writer.Write(pair.Value);
+                    }
+
+                    writer.Write(mergedSegment);
+                }
+            }
+
+            if (File.Exists(CheckpointPath))
+                File.Replace(temporaryPath, CheckpointPath, null);
+            else
+                File.Move(temporaryPath, CheckpointPath);
+        }
+
+        // Only the newest segment can end with a record that was partially written when the server crashed,
+        // any other invalid record is corruption and stops loading without touching the file
+        private void Replay(string path, bool isNewest)
+        {
+            long validLength = 0;
+            using (FileStream fs = new FileStream(path, FileMode.Open, FileAccess.ReadWrite))
+            {
+                using (var reader = new BinaryReader(fs, Encoding.UTF8, true))
+                {
+                    while (fs.Length - fs.Position >= 8)
+                    {
+                        int length = reader.ReadInt32();
+                        if (length < 0)
+                            throw new InvalidDataException($"Invalid record length in {path} at position {validLength}");
+                        if (fs.Length - fs.Position < length + 4)
+                            break;
+
+                        byte[] payload = reader.ReadBytes(length);
+                        if (reader.ReadInt32() != Checksum(payload, length))
+                        {
+                            // A torn record is always the last one
+                            if (fs.Position < fs.Length)
+                                throw new InvalidDataException($"Invalid checksum in {path} at position {validLength}");
+                            break;
+                        }
+
+                        ApplyRecord(payload);
+                        validLength = fs.Position;
+                    }
+                }
+
+                if (validLength < fs.Length)
+                {
+                    if (!isNewest)
+                        throw new InvalidDataException($"Invalid record in {path} at position {validLength}");
+
+                    // Drop the record that was only partially written
+                    fs.SetLength(validLength);
+                }
+            }
+        }
+
+        private void ApplyRecord(byte[] payload)
+        {
+            using (var reader = new BinaryReader(new MemoryStream(payload), Encoding.UTF8))
+            {
+                byte type = reader.ReadByte();
+                string key = reader.ReadString();
+                if (type == SetRecord)
+                    SetValue(key, reader.ReadString());
+                else if (type == DeleteRecord)
+                    RemoveValue(key);
+            }
+        }
+
+        private void SetValue(string key, string value)
+        {
+            if (!_data.ContainsKey(key))
+                _keys.Add(key);
+            _data[key] = value;
+        }
+
+        private void RemoveValue(string key)
+        {
+            if (_data.Remove(key))
+                _keys.Remove(key);
+        }
+
+        // FNV-1a
+        private static int Checksum(byte[] data, int length)
+        {
+            unchecked
+            {
+                uint hash = 2166136261;
+                for (int i = 0; i < length; i++)
+                {
+                    hash = (hash ^ data[i]) * 16777619;
+                }
+
+                return (int)hash;
+            }
+        }
+    }
+}
@@ -0,0 +1,126 @@
+using System;
+using System.Collections.Concurrent;
+using System.Runtime.InteropServices;
+using System.Text;
+
+namespace CLibHost
+{
+    // Minimal stand-in for the engine to test the callback completion mode of the CLib extension framework.
+    // Usage: CLibHost_x64.exe -mod=<mod folder> <extension> <action> [data] [count]
+    public class Program
+    {
+#if WIN64
+        private const string CLibDll = "CLib_x64.dll";
+#else
+        private const string CLibDll = "CLib.dll";
+#endif
+        private const int OutputSize = 10240;
+
+        private const char SOH = '\x01';
+        private const char STX = '\x02';
+        private const char ETX = '\x03';
+        private const char EOT = '\x04';
+        private const char ENQ = '\x05';
+        private const char ACK = '\x06';
+        private const char US = '\x1F';
+
+        [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+        private delegate int ExtensionCallback([MarshalAs(UnmanagedType.LPStr)] string name, [MarshalAs(UnmanagedType.LPStr)] string function, [MarshalAs(UnmanagedType.LPStr)] string data);
+
+#if WIN64
+        [DllImport(CLibDll, EntryPoint = "RVExtension")]
+        private static extern void RVExtension(StringBuilder output, int outputSize, [MarshalAs(UnmanagedType.LPStr)] string input);
+
+        [DllImport(CLibDll, EntryPoint = "RVExtensionRegisterCallback")]
+        private static extern void RVExtensionRegisterCallback(ExtensionCallback callback);
+#else
+        [DllImport(CLibDll, EntryPoint = "_RVExtension@12", CallingConvention = CallingConvention.StdCall)]
+        private static extern void RVExtension(StringBuilder output, int outputSize, [MarshalAs(UnmanagedType.LPStr)] string input);
+
+        [DllImport(CLibDll, EntryPoint = "_RVExtensionRegisterCallback@4", CallingConvention = CallingConvention.StdCall)]
+        private static extern void RVExtensionRegisterCallback(ExtensionCallback callback);
+#endif
+
+        // Like the engine the callback only queues the event, it gets handled on the main thread
+        private static readonly BlockingCollection<string> CallbackQueue = new BlockingCollection<string>();
+        private static readonly ExtensionCallback Callback = (name, function, data) =>
+        {
+            CallbackQueue.Add(name + ":" + function);
+            return 0;
+        };
+
+        public static int Main(string[] args)
+        {
+            int argumentOffset = args.Length > 0 && args[0].StartsWith("-mod=", StringComparison.OrdinalIgnoreCase) ? 1 : 0;
+            if (args.Length - argumentOffset < 2)
+            {
+                Console.WriteLine("Usage: CLibHost -mod=<mod folder> <extension> <action> [data] [count]");
+                return 1;
+            }
+
+            string extensionName = args[argumentOffset];
+            string actionName = args[argumentOffset + 1];
+            string data = args.Length > argumentOffset + 2 ? args[argumentOffset + 2] : "";
+            int count = args.Length > argumentOffset + 3 ? int.Parse(args[argumentOffset + 3]) : 1;
+
+            RVExtensionRegisterCallback(Callback);
+            if (Call("callback") != ACK.ToString())
+            {
+                Console.WriteLine("Callback mode was not accepted");
+                return 1;
+            }
+
+            for (int taskId = 0; taskId < count; taskId++)
+            {
+                string result = Call(SOH + taskId.ToString() + US + extensionName + US + actionName + STX + data + ETX);
+                Console.WriteLine($"Request {taskId}: {Printable(result)}");
+            }
+
+            int pendingTasks = count;
+            while (pendingTasks > 0)
+            {
+                string signal;
+                if (!CallbackQueue.TryTake(out signal, 10000))
+                {
+                    Console.WriteLine($"Timeout with {pendingTasks} pending tasks");
+                    return 1;
+                }
+
+                string result = Call(ENQ.ToString());
+                while (result.Length > 0 && result[result.Length - 1] != EOT)
+                {
+                    result += Call(ACK.ToString());
+                }
+
+                foreach (string taskResult in result.TrimEnd(EOT).Split(new[] { SOH }, StringSplitOptions.RemoveEmptyEntries))
+                {
+                    Console.WriteLine($"Result {Printable(taskResult)}");
+                    pendingTasks--;
+                }
+            }
+
+            return 0;
+        }
+
+        private static string Call(string input)
+        {
+            var output = new StringBuilder(OutputSize);
+            RVExtension(output, OutputSize, input);
+            return output.ToString();
+        }
+
+        private static string Printable(string input)
+        {
+            var printable = new StringBuilder(input.Length);
+            foreach (char character in input)
+            {
+                if (character < ' ')
+                    printable.Append($"<{(int)character:X2}>");
+                else
+                    printable.Append(character);
+            }
+
+            return printable.ToString();
+        }
+    }
+}
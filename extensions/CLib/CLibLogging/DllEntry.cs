@@ -10,9 +10,12 @@ namespace CLibLogging
     public class DllEntry
     {
         private static string startTime = "";
+        private static LogWriter writer;
         static DllEntry()
         {
             startTime = DateTime.Now.ToString("yyyy-MM-dd_HH-mm-ss");
+            writer = new LogWriter(Path.Combine(Environment.CurrentDirectory, "CLib_Logs", startTime.Replace("-", "")), startTime);
+            AppDomain.CurrentDomain.ProcessExit += (sender, args) => writer.Stop();
         }
 
 #if WIN64
@@ -56,19 +59,19 @@ private static string GetVersion()
         public static string Log(string input)
         {
             string[] inputParts = input.Split(new char[] { ':' }, 2);
+            if (inputParts.Length < 2)
+                return "";
 
-            string path = Path.Combine(Environment.CurrentDirectory, "CLib_Logs", startTime.Replace("-", ""));
-            if (!File.Exists(path))
-            {
-                Directory.CreateDirectory(path);
-            }
-            // TODO let the user define the File format
-            using (StreamWriter file = new StreamWriter(path + string.Format("\\CLibLog_{0}_{1}.{2}", startTime, inputParts[0], "log"), true))
-            {
-                string log = DateTime.Now.ToString("HH-mm-ss") + inputParts[1];
-                file.WriteLine(log);
-            }
+            // The time is taken here because the line gets written later by the background thread
+            writer.Enqueue(inputParts[0], DateTime.Now.ToString("HH-mm-ss") + inputParts[1]);
             return "";
         }
+
+        // Returns [queued, written, dropped, rotations]
+        [DllExport("Stats")]
+        public static string Stats(string input)
+        {
+            return writer.Stats();
+        }
     }
-}
+}
\ No newline at end of file
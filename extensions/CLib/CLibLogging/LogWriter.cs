@@ -0,0 +1,211 @@
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Threading;
+
+namespace CLibLogging
+{
+    // Collects log lines in a ring buffer and writes them in batches per file from a background thread
+    public class LogWriter
+    {
+        private const int Capacity = 1 << 16;
+        private const int FlushThreshold = 1024;
+        private const int FlushInterval = 1000;
+        private const long MaxFileSize = 64L << 20;
+        private static readonly TimeSpan MaxFileAge = TimeSpan.FromHours(24);
+
+        private struct LogLine
+        {
+            public string File;
+            public string Text;
+        }
+
+        private class OpenFile
+        {
+            public StreamWriter Writer;
+            public DateTime Opened;
+            public int Part;
+        }
+
+        private readonly string _folder;
+        private readonly string _startTime;
+        private readonly LogLine[] _buffer = new LogLine[Capacity];
+        private int _head;
+        private int _count;
+        private bool _stopped;
+        private readonly Dictionary<string, OpenFile> _files = new Dictionary<string, OpenFile>();
+        private readonly Thread _thread;
+
+        private long _written;
+        private long _dropped;
+        private long _rotations;
+
+        public LogWriter(string folder, string startTime)
+        {
+            _folder = folder;
+            _startTime = startTime;
+            _thread = new Thread(Run) { IsBackground = true, Name = "CLibLogging" };
+            _thread.Start();
+        }
+
+        // Returns false if the buffer is full and the line got dropped
+        public bool Enqueue(string file, string text)
+        {
+            lock (_buffer)
+            {
+                if (_count == Capacity || _stopped)
+                {
+                    Interlocked.Increment(ref _dropped);
+                    return false;
+                }
+
+                _buffer[(_head + _count) % Capacity] = new LogLine { File = file, Text = text };
+                _count++;
+
+                if (_count == FlushThreshold)
+                    Monitor.Pulse(_buffer);
+            }
+
+            return true;
+        }
+
+        // Formatted as a SQF array: [queued, written, dropped, rotations]
+        public string Stats()
+        {
+            lock (_buffer)
+            {
+                return $"[{_count},{Interlocked.Read(ref _written)},{Interlocked.Read(ref _dropped)},{Interlocked.Read(ref _rotations)}]";
+            }
+        }
+
+        // Writes everything that is queued and closes all files
+        public void Stop()
+        {
+            lock (_buffer)
+            {
+                _stopped = true;
+                Monitor.Pulse(_buffer);
+            }
+
+            _thread.Join();
+        }
+
+        private void Run()
+        {
+            var batch = new List<LogLine>(FlushThreshold);
+            while (true)
+            {
+                bool stopped;
+                lock (_buffer)
+                {
+                    if (_count < FlushThreshold && !_stopped)
+                        Monitor.Wait(_buffer, FlushInterval);
+
+                    while (_count > 0)
+                    {
+                        batch.Add(_buffer[_head]);
+                        _buffer[_head] = default(LogLine);
+                        _head = (_head + 1) % Capacity;
+                        _count--;
+                    }
+
+                    stopped = _stopped;
+                }
+
+                Write(batch);
+                batch.Clear();
+
+                if (stopped)
+                    break;
+            }
+
+            foreach (OpenFile file in _files.Values)
+            {
+                if (file.Writer != null)
+                    file.Writer.Dispose();
+            }
+            _files.Clear();
+        }
+
+        private void Write(List<LogLine> batch)
+        {
+            var touchedFiles = new HashSet<OpenFile>();
+            foreach (LogLine line in batch)
+            {
+                try
+                {
+                    OpenFile file = GetFile(line.File);
+                    file.Writer.WriteLine(line.Text);
+                    touchedFiles.Add(file);
+                    Interlocked.Increment(ref _written);
+                }
+                catch (Exception)
+                {
+                    Interlocked.Increment(ref _dropped);
+                }
+            }
+
+            foreach (OpenFile file in touchedFiles)
+            {
+                try
+                {
+                    file.Writer.Flush();
+                }
+                catch (Exception)
+                {
+                    // The writer closes its stream even if the final flush fails, the next line for this file opens it again
+                    try
+                    {
+                        file.Writer.Dispose();
+                    }
+                    catch (Exception)
+                    {
+                    }
+                }
+            }
+        }
+
+        private OpenFile GetFile(string name)
+        {
+            OpenFile file;
+            if (_files.TryGetValue(name, out file))
+            {
+                // A writer that failed to open is opened again with the same part
+                if (file.Writer == null || file.Writer.BaseStream == null)
+                {
+                    file.Writer = OpenWriter(name, file.Part);
+                    file.Opened = DateTime.Now;
+                    return file;
+                }
+
+                if (file.Writer.BaseStream.Length < MaxFileSize && DateTime.Now - file.Opened < MaxFileAge)
+                    return file;
+
+                // The old writer is only replaced once the next part could be opened
+                StreamWriter writer = OpenWriter(name, file.Part + 1);
+                file.Writer.Dispose();
+                file.Writer = writer;
+                file.Part++;
+                file.Opened = DateTime.Now;
+                Interlocked.Increment(ref _rotations);
+                return file;
+            }
+
+            file = new OpenFile();
+            file.Writer = OpenWriter(name, 0);
+            file.Opened = DateTime.Now;
+            _files.Add(name, file);
+            return file;
+        }
+
+        private StreamWriter OpenWriter(string name, int part)
+        {
+            Directory.CreateDirectory(_folder);
+            // TODO let the user define the File format
+            string fileName = part == 0
+                ? string.Format("CLibLog_{0}_{1}.{2}", _startTime, name, "log")
+                : string.Format("CLibLog_{0}_{1}_{2}.{3}", _startTime, name, part, "log");
+            return new StreamWriter(Path.Combine(_folder, fileName), true);
+        }
+    }
+}
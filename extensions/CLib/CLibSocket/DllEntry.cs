@@ -1,4 +1,5 @@
 using System;
+using System.Collections.Concurrent;
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.Linq;
@@ -45,13 +46,9 @@ enum UDP_TABLE_CLASS
         [DllImport("iphlpapi.dll", SetLastError = true)]
         private static extern uint GetExtendedUdpTable(IntPtr pTcpTable, ref int dwOutBufLen, bool sort, int ipVersion, UDP_TABLE_CLASS tblClass, uint reserved = 0);
 
-        private class TcpClientEntry
-        {
-            public Uri Uri;
-            public TcpClient TcpClient;
-        }
+        private const int DefaultReceiveCount = 100;
 
-        private static Dictionary<string, TcpClientEntry> tcpClients = new Dictionary<string, TcpClientEntry>();
+        private static ConcurrentDictionary<string, SocketConnection> connections = new ConcurrentDictionary<string, SocketConnection>();
         private static Timer tickTimer;
         private static List<int> serverPorts = new List<int>();
         private static ReaderWriterLock locker = new ReaderWriterLock();
@@ -107,7 +104,7 @@ private static string GetVersion()
             }
             Log(hash);
 
-            if (DllEntry.tcpClients.ContainsKey(hash)) {
+            if (DllEntry.connections.ContainsKey(hash)) {
                 return hash;
             }
 
@@ -117,9 +114,11 @@ private static string GetVersion()
                 return "error";
             }
 
+            // The connection is established in the background and reconnects on its own
             Log("Connecting to: " + uri.Host + ":" + uri.Port);
-            TcpClient tcpClient = DllEntry.Connect(uri);
-            DllEntry.tcpClients.Add(hash, new TcpClientEntry() { Uri = uri, TcpClient = tcpClient });
+            var connection = new SocketConnection(uri);
+            if (DllEntry.connections.TryAdd(hash, connection))
+                connection.Start();
 
             return hash;
         }
@@ -127,106 +126,82 @@ private static string GetVersion()
         [DllExport("Disconnect")]
         public static string Disconnect(string hash)
         {
-            if (!DllEntry.tcpClients.ContainsKey(hash))
+            SocketConnection connection;
+            if (!DllEntry.connections.TryRemove(hash, out connection))
             {
                 return "false";
             }
-            
-            DllEntry.tcpClients[hash].TcpClient.Close();
-            DllEntry.tcpClients.Remove(hash);
-            
+
+            connection.Close();
+
             return "success";
         }
 
         [DllExport("IsConnected")]
         public static string IsConnected(string hash)
         {
-            if (!DllEntry.tcpClients.ContainsKey(hash))
+            SocketConnection connection;
+            if (!DllEntry.connections.TryGetValue(hash, out connection))
             {
                 return "error";
             }
 
-            return DllEntry.IsConnected(DllEntry.tcpClients[hash].TcpClient) ? "success" : "false";
+            return connection.Connected ? "success" : "false";
         }
 
+        // Messages are queued and also kept while the socket reconnects
         [DllExport("Send")]
         public static string Send(string data) {
             string[] dataParts = data.Split(new char[] { ':' }, 2);
             string hash = dataParts[0];
-            data = dataParts[1];
+            data = dataParts.Length > 1 ? dataParts[1] : "";
 
-            if (!DllEntry.tcpClients.ContainsKey(hash))
+            SocketConnection connection;
+            if (!DllEntry.connections.TryGetValue(hash, out connection))
                 return "Socket for address not connected";
 
-            DllEntry.Send(DllEntry.tcpClients[hash].TcpClient, data);
+            if (!connection.Send(data))
+                return "Send queue full";
 
             return "success";
         }
 
-        private static TcpClient Connect(Uri uri)
+        // Input is hash or hash:count, returns the received messages as SQF array of strings
+        [DllExport("Receive")]
+        public static string Receive(string data)
         {
-            TcpClient tcpClient = new TcpClient(uri.Host, uri.Port);
-            tcpClient.Client.SetSocketOption(SocketOptionLevel.Socket, SocketOptionName.KeepAlive, true);
-            return tcpClient;
-        }
+            string[] dataParts = data.Split(new char[] { ':' }, 2);
+            int count;
+            if (dataParts.Length < 2 || !int.TryParse(dataParts[1], out count))
+                count = DllEntry.DefaultReceiveCount;
 
-        private static bool IsConnected(TcpClient tcpClient)
-        {
-            try
-            {
-                return tcpClient.Connected && !(tcpClient.Client.Poll(1, SelectMode.SelectRead) && tcpClient.Client.Available == 0);
-            }
-            catch (ObjectDisposedException)
-            {
-                return false;
-            }
+            SocketConnection connection;
+            if (!DllEntry.connections.TryGetValue(dataParts[0], out connection))
+                return "error";
+
+            return "[" + string.Join(",", connection.Receive(count).Select(message => "\"" + message.Replace("\"", "\"\"") + "\"")) + "]";
         }
 
-        private static void Send(TcpClient tcpClient, string message)
+        // Returns [connected, queued sends, queued receives, sent, received, dropped, reconnects]
+        [DllExport("Stats")]
+        public static string Stats(string hash)
         {
-            byte[] dataBytes = Encoding.Default.GetBytes(message);
-            tcpClient.GetStream().Write(dataBytes, 0, dataBytes.Length);
+            SocketConnection connection;
+            if (!DllEntry.connections.TryGetValue(hash, out connection))
+                return "error";
+
+            return connection.Stats();
         }
 
         private static void OnTick(object state)
         {
-            DllEntry.ReconnectAllSockets();
-
             List<int> ports = DllEntry.GetArmaServerPorts();
             if (!ports.SequenceEqual(DllEntry.serverPorts))
             {
                 DllEntry.serverPorts = ports;
-                foreach (TcpClientEntry tcpClientEntry in DllEntry.tcpClients.Values)
-                {
-                    DllEntry.Send(tcpClientEntry.TcpClient, $"PORTS:{string.Join(":", DllEntry.serverPorts)}");
-                }
-            }
-        }
-
-        private static void ReconnectAllSockets()
-        {
-            foreach (KeyValuePair<string, TcpClientEntry> kvPair in DllEntry.tcpClients)
-            {
-                string hash = kvPair.Key;
-                TcpClientEntry entry = kvPair.Value;
-
-                if (!DllEntry.IsConnected(entry.TcpClient))
+                foreach (SocketConnection connection in DllEntry.connections.Values)
                 {
-                    try
-                    {
-                        entry.TcpClient.Close();
-                    }
-                    catch (ObjectDisposedException) { }
-
-                    try
-                    {
-                        entry.TcpClient = DllEntry.Connect(entry.Uri);
-                        Log("Reconnected");
-                    }
-                    catch (SocketException e)
-                    {
-                        Log($"Reconnect - Socket exception {e.Message}");
-                    }
+                    connection.Send($"PORTS:{string.Join(":", DllEntry.serverPorts)}");
                 }
             }
         }
@@ -266,7 +241,7 @@ private static List<int> GetArmaServerPorts()
             return ports;
         }
 
-        private static void Log(params object[] obj) {
+        internal static void Log(params object[] obj) {
             try
             {
                 locker.AcquireWriterLock(int.MaxValue);
@@ -0,0 +1,232 @@
+using System;
+using System.Collections.Concurrent;
+using System.Collections.Generic;
+using System.IO;
+using System.Net.Sockets;
+using System.Text;
+using System.Threading;
+using System.Threading.Tasks;
+
+namespace CLibSocket
+{
+    // Connection which sends and receives length prefixed messages without blocking the caller.
+    // Every message is framed as [4 byte big endian length][UTF-8 payload] in both directions.
+    public class SocketConnection
+    {
+        private const int MaxSendQueueLength = 1024;
+        private const int MaxReceiveQueueLength = 4096;
+        private const int MaxFrameSize = 16 << 20;
+        private const int MinReconnectDelay = 500;
+        private const int MaxReconnectDelay = 60000;
+
+        public Uri Uri { get; }
+        public bool Connected => _client != null;
+
+        private readonly ConcurrentQueue<byte[]> _sendQueue = new ConcurrentQueue<byte[]>();
+        private readonly ConcurrentQueue<string> _receiveQueue = new ConcurrentQueue<string>();
+        private readonly SemaphoreSlim _sendSignal = new SemaphoreSlim(0);
+        private readonly CancellationTokenSource _closed = new CancellationTokenSource();
+        private volatile TcpClient _client;
+        private int _sendQueueLength;
+        private int _receiveQueueLength;
+
+        private long _sent;
+        private long _received;
+        private long _dropped;
+        private long _reconnects;
+
+        public SocketConnection(Uri uri)
+        {
+            Uri = uri;
+        }
+
+        public void Start()
+        {
+            Task.Run(() => Run());
+        }
+
+        // Returns false if the send queue is full
+        public bool Send(string message)
+        {
+            if (Interlocked.Increment(ref _sendQueueLength) > MaxSendQueueLength)
+            {
+                Interlocked.Decrement(ref _sendQueueLength);
+                Interlocked.Increment(ref _dropped);
+                return false;
+            }
+
+            // The engine passes the UTF-8 bytes as an ANSI string, the default code page gives back the original bytes
+            byte[] payload = Encoding.Default.GetBytes(message);
+            byte[] frame = new byte[payload.Length + 4];
+            WriteLength(frame, payload.Length);
+            payload.CopyTo(frame, 4);
+
+            _sendQueue.Enqueue(frame);
+            _sendSignal.Release();
+            return true;
+        }
+
+        // Removes up to count received messages from the queue
+        public List<string> Receive(int count)
+        {
+            var messages = new List<string>();
+            string message;
+            while (messages.Count < count && _receiveQueue.TryDequeue(out message))
+            {
+                Interlocked.Decrement(ref _receiveQueueLength);
+                messages.Add(message);
+            }
+
+            return messages;
+        }
+
+        // Formatted as a SQF array: [connected, queued sends, queued receives, sent, received, dropped, reconnects]
+        public string Stats()
+        {
+            return $"[{(Connected ? "true" : "false")},{Volatile.Read(ref _sendQueueLength)},{Volatile.Read(ref _receiveQueueLength)},{Interlocked.Read(ref _sent)},{Interlocked.Read(ref _received)},{Interlocked.Read(ref _dropped)},{Interlocked.Read(ref _reconnects)}]";
+        }
+
+        public void Close()
+        {
+            _closed.Cancel();
+            _client?.Close();
+        }
+
+        private async Task Run()
+        {
+            int reconnectDelay = MinReconnectDelay;
+            CancellationToken token = _closed.Token;
+
+            while (!token.IsCancellationRequested)
+            {
+                var client = new TcpClient();
+                try
+                {
+                    await client.ConnectAsync(Uri.Host, Uri.Port);
+                    client.Client.SetSocketOption(SocketOptionLevel.Socket, SocketOptionName.KeepAlive, true);
+                    client.NoDelay = true;
+                    _client = client;
+                    reconnectDelay = MinReconnectDelay;
+                    DllEntry.Log("Connected to: " + Uri.Host + ":" + Uri.Port);
+
+                    NetworkStream stream = client.GetStream();
+                    using (var lost = CancellationTokenSource.CreateLinkedTokenSource(token))
+                    {
+                        // Whichever loop fails first takes the other one down with the connection
+                        Task sending = SendLoop(stream, lost.Token);
+                        Task receiving = ReceiveLoop(stream, lost.Token);
+                        await Task.WhenAny(sending, receiving);
+                        lost.Cancel();
+                        client.Close();
+                        try
+                        {
+                            await Task.WhenAll(sending, receiving);
+                        }
+                        catch (Exception) { }
+                    }
+                }
+                catch (Exception e)
+                {
+                    DllEntry.Log($"Socket {Uri.Host}:{Uri.Port} - {e.Message}");
+                }
+                finally
+                {
+                    _client = null;
+                    client.Close();
+                }
+
+                if (token.IsCancellationRequested)
+                    break;
+
+                try
+                {
+                    await Task.Delay(reconnectDelay, token);
+                }
+                catch (OperationCanceledException)
+                {
+                    break;
+                }
+
+                reconnectDelay = Math.Min(reconnectDelay * 2, MaxReconnectDelay);
+                Interlocked.Increment(ref _reconnects);
+            }
+        }
+
+        private async Task SendLoop(NetworkStream stream, CancellationToken token)
+        {
+            byte[] frame = null;
+            while (true)
+            {
+                await _sendSignal.WaitAsync(token);
+
+                // A frame that failed to send stays at the front of the queue for the next connection
+                if (!_sendQueue.TryPeek(out frame))
+                    continue;
+
+                try
+                {
+                    await stream.WriteAsync(frame, 0, frame.Length, token);
+                }
+                catch (Exception)
+                {
+                    _sendSignal.Release();
+                    throw;
+                }
+
+                _sendQueue.TryDequeue(out frame);
+                Interlocked.Decrement(ref _sendQueueLength);
+                Interlocked.Increment(ref _sent);
+            }
+        }
+
+        private async Task ReceiveLoop(NetworkStream stream, CancellationToken token)
+        {
+            byte[] header = new byte[4];
+            while (true)
+            {
+                await ReadExactly(stream, header, 4, token);
+                int length = ReadLength(header);
+                if (length < 0 || length > MaxFrameSize)
+                    throw new InvalidDataException($"Invalid frame length {length}");
+
+                byte[] payload = new byte[length];
+                await ReadExactly(stream, payload, length, token);
+
+                if (Interlocked.Increment(ref _receiveQueueLength) > MaxReceiveQueueLength)
+                {
+                    Interlocked.Decrement(ref _receiveQueueLength);
+                    Interlocked.Increment(ref _dropped);
+                    continue;
+                }
+
+                _receiveQueue.Enqueue(Encoding.Default.GetString(payload));
+                Interlocked.Increment(ref _received);
+            }
+        }
+
+        private static async Task ReadExactly(NetworkStream stream, byte[] buffer, int count, CancellationToken token)
+        {
+            int offset = 0;
+            while (offset < count)
+            {
+                int read = await stream.ReadAsync(buffer, offset, count - offset, token);
+                if (read == 0)
+                    throw new EndOfStreamException("Connection closed by remote host");
+                offset += read;
+            }
+        }
+
+        private static void WriteLength(byte[] buffer, int length)
+        {
+            buffer[0] = (byte)(length >> 24);
+            buffer[1] = (byte)(length >> 16);
+            buffer[2] = (byte)(length >> 8);
+            buffer[3] = (byte)length;
+        }
+
+        private static int ReadLength(byte[] buffer)
+        {
+            return (buffer[0] << 24) | (buffer[1] << 16) | (buffer[2] << 8) | buffer[3];
+        }
+    }
+}
@@ -0,0 +1,568 @@
+#!/usr/bin/env python3
+
+# Prebuilds every function listed in cfgCLibModules.hpp so the server does not need to preprocess,
+# strip and compress the library on every start. The output mirrors what fn_compile.sqf would produce
+# at runtime and is loaded by fn_loadPrebuiltFunctions.sqf. Functions that are not part of the artifact
+# (e.g. mission modules) are still compiled at runtime.
+
+import os
+import re
+import sys
+import argparse
+
+PBOPREFIX_FILE = "$PBOPREFIX$"
+ARTIFACT_NAME = "prebuiltFunctions.sqf"
+
+# Compression constants, have to match CLibCompression and fn_decompressString.sqf
+WINDOWSIZE = 1 << 11
+MINMATCHLENGTH = 2
+MAXMATCHLENGTH = (1 << 4) - MINMATCHLENGTH
+TRIGRAMLENGTH = MINMATCHLENGTH + 1
+HASHSIZE = 1 << 15
+
+# Same header as fn_compile.sqf without DEBUGFULL
+FUNCTION_HEADER = """private _fnc_scriptNameParent = if (isNil '_fnc_scriptName') then {
+    '%1'
+} else {
+    _fnc_scriptName
+};
+
+private _fnc_scriptName = '%1';
+scriptName _fnc_scriptName;
+scopeName (_fnc_scriptName + '_Main');
+"""
+
+identifierRegex = re.compile(r"[A-Za-z_][A-Za-z0-9_]*")
+
+
+class ExternalIncludeError(Exception):
+    pass
+
+
+class Macro:
+    def __init__(self, params, body):
+        self.params = params
+        self.body = body
+
+
+class Preprocessor:
+    """Subset of the Arma preprocessor which covers everything CLib uses:
+    #include, #define (with arguments, # and ##), #undef, #ifdef, #ifndef, #else, #endif, __FILE__ and __LINE__
+    Double quoted strings are never expanded, everything else is."""
+
+    def __init__(self, addonRoot, addonPrefix):
+        self.addonRoot = addonRoot
+        self.addonPrefix = addonPrefix.strip("\\")
+        self.macros = {}
+
+    def resolvePath(self, includePath, currentFile):
+        if includePath.startswith("\\"):
+            path = includePath.strip("\\")
+            if not path.lower().startswith(self.addonPrefix.lower()):
+                raise ExternalIncludeError("Include {0} in {1} is outside of the addon".format(includePath, currentFile))
+            path = path[len(self.addonPrefix):].strip("\\")
+            return os.path.join(self.addonRoot, *path.split("\\"))
+        return os.path.join(os.path.dirname(currentFile), *includePath.split("\\"))
+
+    def gamePath(self, path):
+        relativePath = os.path.relpath(path, self.addonRoot).replace(os.sep, "\\")
+        return self.addonPrefix + "\\" + relativePath
+
+    def processFile(self, path):
+        path = findFile(path)
+        with open(path, 'r', encoding='utf-8-sig') as file:
+            content = file.read().replace("\r\n", "\n")
+
+        content = removeComments(content).replace("\\\n", "")
+        output = []
+        block = []
+        blockStartLine = 1
+        # Every entry is [parentActive, condition]
+        conditionStack = []
+        active = True
+
+        def flushBlock():
+            if block:
+                output.append(self.expand("\n".join(block), set(), path, blockStartLine))
+                block.clear()
+
+        for lineIndex, line in enumerate(content.split("\n")):
+            stripped = line.strip()
+            if not stripped.startswith("#"):
+                if active:
+                    if not block:
+                        blockStartLine = lineIndex + 1
+                    block.append(line)
+                continue
+
+            flushBlock()
+            directive, _, argument = stripped[1:].partition(" ")
+            argument = argument.strip()
+            if directive == "ifdef" or directive == "ifndef":
+                condition = (argument in self.macros) == (directive == "ifdef")
+                conditionStack.append([active, condition])
+                active = active and condition
+            elif directive == "else":
+                parentActive, condition = conditionStack[-1]
+                active = parentActive and not condition
+            elif directive == "endif":
+                active = conditionStack.pop()[0]
+            elif not active:
+                continue
+            elif directive == "define":
+                self.define(argument)
+            elif directive == "undef":
+                self.macros.pop(argument, None)
+            elif directive == "include":
+                includeFile = self.resolvePath(argument[1:-1], path)
+                output.append(self.processFile(includeFile))
+            else:
+                raise Exception("Unsupported directive #{0} in {1}:{2}".format(directive, path, lineIndex + 1))
+
+        flushBlock()
+        return "\n".join(output)
+
+    def define(self, definition):
+        match = identifierRegex.match(definition)
+        name = match.group(0)
+        rest = definition[match.end():]
+        params = None
+        if rest.startswith("("):
+            end = rest.index(")")
+            params = [param.strip() for param in rest[1:end].split(",")]
+            rest = rest[end + 1:]
+        self.macros[name] = Macro(params, rest.strip())
+
+    # Macro bodies are expanded with the line of the outermost macro call
+    def expand(self, text, disabled, path, line, countLines=True):
+        output = []
+        index = 0
+        length = len(text)
+        while index < length:
+            char = text[index]
+            if char == '"':
+                end = text.find('"', index + 1)
+                end = length if end == -1 else end + 1
+                output.append(text[index:end])
+                index = end
+                continue
+
+            match = identifierRegex.match(text, index) if (char.isalpha() or char == "_") else None
+            if match is None or (index > 0 and (text[index - 1].isalnum() or text[index - 1] == "_")):
+                output.append(char)
+                index += 1
+                continue
+
+            name = match.group(0)
+            currentLine = line
+            if countLines and (name == "__LINE__" or name in self.macros):
+                currentLine += text.count("\n", 0, index)
+            index = match.end()
+            if name == "__FILE__":
+                output.append('"' + self.gamePath(path) + '"')
+            elif name == "__LINE__":
+                output.append(str(currentLine))
+            elif name not in self.macros or name in disabled:
+                output.append(name)
+            else:
+                macro = self.macros[name]
+                if macro.params is None:
+                    output.append(self.expand(macro.body, disabled | {name}, path, currentLine, False))
+                elif index < length and text[index] == "(":
+                    arguments, index = splitArguments(text, index + 1)
+                    arguments = [self.expand(argument, disabled, path, currentLine, False) for argument in arguments]
+                    body = substitute(macro, arguments)
+                    output.append(self.expand(body, disabled | {name}, path, currentLine, False))
+                else:
+                    output.append(name)
+
+        return "".join(output)
+
+
+# Game paths are case insensitive, the file system might not be
+def findFile(path):
+    if os.path.exists(path):
+        return path
+    parent, name = os.path.split(path)
+    parent = findFile(parent) if parent else "."
+    for entry in os.listdir(parent):
+        if entry.lower() == name.lower():
+            return os.path.join(parent, entry)
+    raise FileNotFoundError(path)
+
+
+def removeComments(content):
+    output = []
+    index = 0
+    length = len(content)
+    while index < length:
+        char = content[index]
+        if char == '"':
+            end = content.find('"', index + 1)
+            end = length if end == -1 else end + 1
+            output.append(content[index:end])
+            index = end
+        elif content.startswith("//", index):
+            end = content.find("\n", index)
+            index = length if end == -1 else end
+        elif content.startswith("/*", index):
+            end = content.find("*/", index + 2)
+            end = length if end == -1 else end + 2
+            # keep the line numbers intact
+            output.append("\n" * content.count("\n", index, end))
+            index = end
+        else:
+            output.append(char)
+            index += 1
+    return "".join(output)
+
+
+# Splits macro arguments at commas which are not inside of round brackets or strings
+def splitArguments(text, index):
+    arguments = []
+    current = []
+    depth = 0
+    while True:
+        char = text[index]
+        if char == '"':
+            end = text.index('"', index + 1) + 1
+            current.append(text[index:end])
+            index = end
+            continue
+        if char == "(":
+            depth += 1
+        elif char == ")":
+            if depth == 0:
+                arguments.append("".join(current).strip())
+                return arguments, index + 1
+            depth -= 1
+        elif char == "," and depth == 0:
+            arguments.append("".join(current).strip())
+            current = []
+            index += 1
+            continue
+        current.append(char)
+        index += 1
+
+
+def substitute(macro, arguments):
+    values = dict(zip(macro.params, arguments))
+    body = macro.body
+    output = []
+    index = 0
+    length = len(body)
+    while index < length:
+        char = body[index]
+        if char == '"':
+            end = body.find('"', index + 1)
+            end = length if end == -1 else end + 1
+            output.append(body[index:end])
+            index = end
+        elif body.startswith("##", index):
+            while output and output[-1].isspace():
+                output.pop()
+            index += 2
+            while index < length and body[index].isspace():
+                index += 1
+        elif char == "#":
+            match = identifierRegex.match(body, index + 1)
+            if match and match.group(0) in values:
+                output.append('"' + values[match.group(0)] + '"')
+                index = match.end()
+            else:
+                output.append(char)
+                index += 1
+        elif char.isalpha() or char == "_":
+            match = identifierRegex.match(body, index)
+            name = match.group(0)
+            output.append(values.get(name, name))
+            index = match.end()
+        else:
+            output.append(char)
+            index += 1
+    return "".join(output)
+
+
+# Port of fn_stripSqf.sqf
+def stripSqf(inputStr):
+    whiteSpaces = set(" \n\r")
+    operatorAndBraces = set("+-*/%&|<>=:,;(){}[]\"'")
+    allSpecialChar = whiteSpaces | operatorAndBraces
+
+    sqString = False
+    dqString = False
+    inPreProcessor = False
+    lastC = ""
+    token = []
+    output = []
+
+    for char in inputStr:
+        if sqString or dqString or inPreProcessor:
+            if dqString and char == '"' and lastC != '"':
+                dqString = False
+            if sqString and char == "'" and lastC != "'":
+                sqString = False
+            if inPreProcessor and char == "\n" and lastC != "\\":
+                inPreProcessor = False
+            output.append(char)
+            lastC = char
+        else:
+            dqString = char == '"'
+            sqString = char == "'"
+            inPreProcessor = char == "#"
+            if sqString or dqString or inPreProcessor:
+                output.append("".join(token).lower())
+                token = []
+                if inPreProcessor:
+                    output.append("\n")
+                output.append(char)
+                lastC = ""
+            elif char in allSpecialChar:
+                output.append("".join(token).lower())
+                token = []
+                if char in operatorAndBraces:
+                    output.append(char)
+                    lastC = char
+            else:
+                if not token and lastC != "" and lastC not in operatorAndBraces:
+                    output.append(" ")
+                lastC = char
+                token.append(char)
+
+    output.append("".join(token).lower())
+    return "".join(output)
+
+
+# Port of the Compress action of CLibCompression
+def compressString(inputStr):
+    if len(inputStr) <= MINMATCHLENGTH:
+        return inputStr
+
+    def matchLength(inputPosition, searchSteps, windowPosition):
+        currentMatchLength = 1
+        while (inputPosition + currentMatchLength < len(inputStr)
+               and inputStr[inputPosition - searchSteps + ((searchSteps - windowPosition + currentMatchLength) % searchSteps)] == inputStr[inputPosition + currentMatchLength]
+               and currentMatchLength < MAXMATCHLENGTH):
+            currentMatchLength += 1
+        return currentMatchLength
+
+    def trigramHash(position):
+        return ((ord(inputStr[position]) << 10) ^ (ord(inputStr[position + 1]) << 5) ^ ord(inputStr[position + 2])) & (HASHSIZE - 1)
+
+    output = [inputStr[0:MINMATCHLENGTH]]
+    writeBuffer = []
+    symbolsWritten = 0
+    encodeFlag = 1
+    hashHead = [-1] * HASHSIZE
+    hashPrevious = [-1] * len(inputStr)
+    hashedUntil = 0
+
+    inputPosition = MINMATCHLENGTH
+    while inputPosition < len(inputStr):
+        currentChar = inputStr[inputPosition]
+        searchSteps = min(WINDOWSIZE, inputPosition)
+        bestMatchLength = 0
+        bestMatchOffset = 0
+
+        windowPosition = 1
+        while windowPosition < TRIGRAMLENGTH and windowPosition <= searchSteps:
+            if currentChar == inputStr[inputPosition - windowPosition]:
+                currentMatchLength = matchLength(inputPosition, searchSteps, windowPosition)
+                if currentMatchLength > bestMatchLength:
+                    bestMatchLength = currentMatchLength
+                    bestMatchOffset = windowPosition
+            windowPosition += 1
+
+        while hashedUntil <= inputPosition - TRIGRAMLENGTH:
+            trigram = trigramHash(hashedUntil)
+            hashPrevious[hashedUntil] = hashHead[trigram]
+            hashHead[trigram] = hashedUntil
+            hashedUntil += 1
+
+        if inputPosition + TRIGRAMLENGTH <= len(inputStr):
+            candidate = hashHead[trigramHash(inputPosition)]
+            while candidate >= 0 and inputPosition - candidate <= searchSteps and bestMatchLength < MAXMATCHLENGTH:
+                windowPosition = inputPosition - candidate
+                if currentChar == inputStr[candidate]:
+                    currentMatchLength = matchLength(inputPosition, searchSteps, windowPosition)
+                    if currentMatchLength > bestMatchLength:
+                        bestMatchLength = currentMatchLength
+                        bestMatchOffset = windowPosition
+                candidate = hashPrevious[candidate]
+
+        symbolsWritten += 1
+
+        if bestMatchLength > MINMATCHLENGTH:
+            inputPosition += bestMatchLength - 1
+            encodeFlag |= 1 << symbolsWritten
+            writeBuffer.append(chr(((bestMatchOffset >> 4) << 1) | 0x1))
+            writeBuffer.append(chr(((bestMatchOffset & 0xF) << 4) | (bestMatchLength - MINMATCHLENGTH)))
+        else:
+            writeBuffer.append(currentChar)
+
+        if symbolsWritten == 7:
+            output.append(chr(encodeFlag))
+            output.extend(writeBuffer)
+            encodeFlag = 1
+            symbolsWritten = 0
+            writeBuffer = []
+
+        inputPosition += 1
+
+    if writeBuffer:
+        output.append(chr(encodeFlag))
+        output.extend(writeBuffer)
+
+    return "".join(output)
+
+
+# Port of fn_hashString.sqf
+def hashString(inputStr):
+    hash1 = len(inputStr)
+    hash2 = 0
+    hash3 = 0
+    for char in inputStr:
+        hash1 = (hash1 * 31 + ord(char)) % 65521
+        hash2 = (hash2 * 37 + ord(char)) % 65519
+        hash3 = (hash3 * 41 + ord(char)) % 65497
+    return "{0}_{1}_{2}".format(hash1, hash2, hash3)
+
+
+# Minimal config parser, returns [name, properties, children] where children is a list of the same structure
+def parseConfig(content):
+    tokens = re.findall(r'"(?:[^"]|"")*"|[A-Za-z0-9_\.\\]+|\[\]|[{};:=,]', content)
+    position = 0
+
+    def parseBody(name):
+        nonlocal position
+        properties = {}
+        children = []
+        while position < len(tokens) and tokens[position] != "}":
+            token = tokens[position]
+            if token == "class":
+                childName = tokens[position + 1]
+                position += 2
+                if tokens[position] == ":":
+                    position += 2
+                if tokens[position] == ";":
+                    children.append([childName, {}, []])
+                    position += 1
+                    continue
+                position += 1
+                children.append(parseBody(childName))
+                position += 2
+            elif token == ";":
+                position += 1
+            else:
+                isArray = tokens[position + 1] == "[]"
+                position += 3 if isArray else 2
+                if isArray:
+                    values = []
+                    position += 1
+                    while tokens[position] != "}":
+                        if tokens[position] != ",":
+                            values.append(tokens[position].strip('"'))
+                        position += 1
+                    position += 1
+                    properties[token] = values
+                else:
+                    properties[token] = tokens[position].strip('"')
+                    position += 1
+        return [name, properties, children]
+
+    return parseBody("")
+
+
+def readFunctions(addonRoot, preprocessor):
+    modulesConfig = parseConfig(preprocessor.processFile(os.path.join(addonRoot, "cfgCLibModules.hpp")))
+    functions = []
+
+    def checkNext(modName, moduleName, modulePath, config):
+        name, properties, children = config
+        if not children:
+            api = properties.get("api") == "1"
+            functionName = "{0}_fnc_{2}" if api else "{0}_{1}_fnc_{2}"
+            functionName = functionName.format(modName, moduleName, name)
+            functionPath = os.path.join(addonRoot, *modulePath, "fn_{0}.sqf".format(name))
+            functions.append([functionName, functionPath])
+        else:
+            for child in children:
+                checkNext(modName, moduleName, modulePath + [name], child)
+
+    cfgCLibModules = next(child for child in modulesConfig[2] if child[0] == "CfgCLibModules")
+    for mod in cfgCLibModules[2]:
+        modName = mod[0]
+        for module in mod[2]:
+            for child in module[2]:
+                checkNext(modName, module[0], [module[0]], child)
+
+    return functions
+
+
+def escapeString(inputStr):
+    return '"' + inputStr.replace('"', '""') + '"'
+
+
+def main():
+    parser = argparse.ArgumentParser()
+    parser.add_argument('-o', '--output', help='artifact file (Default: addons/CLib/' + ARTIFACT_NAME + ')', required=False, default="")
+    parser.add_argument('--clean', help='reset the artifact so all functions get compiled at runtime', action='store_true')
+    args = parser.parse_args()
+
+    # Allow running from root directory as well as from inside the tools directory
+    addonRoot = "../addons/CLib"
+    if (os.path.exists("addons")):
+        addonRoot = "addons/CLib"
+
+    outputPath = args.output or os.path.join(addonRoot, ARTIFACT_NAME)
+
+    if args.clean:
+        with open(outputPath, 'w', encoding='utf-8', newline='\n') as file:
+            file.write("[]")
+        print("Reset {0}".format(outputPath))
+        return 0
+
+    with open(os.path.join(addonRoot, PBOPREFIX_FILE), 'r', encoding='utf-8') as file:
+        addonPrefix = file.read().strip()
+
+    preprocessor = Preprocessor(addonRoot, addonPrefix)
+    preprocessor.processFile(os.path.join(addonRoot, "CLib_Macros.hpp"))
+    if "ISDEV" in preprocessor.macros:
+        print("WARNING: ISDEV is defined, fn_compile.sqf ignores the prebuilt functions in development builds")
+    version = preprocessor.expand("VERSION", set(), outputPath, 0).replace(" ", "")
+
+    functions = readFunctions(addonRoot, preprocessor)
+    entries = []
+    totalSize = 0
+    compressedSize = 0
+    for functionName, functionPath in functions:
+        # Every function gets preprocessed with a clean set of macros like preprocessFileLineNumbers does
+        preprocessor.macros = {}
+        try:
+            code = preprocessor.processFile(functionPath)
+        except ExternalIncludeError as error:
+            # Game files are not available here, these functions are compiled at runtime
+            print("Skipped {0}: {1}".format(functionName, error))
+            continue
+
+        lineDirective = '#line 1 "\\{0}"\n'.format(preprocessor.gamePath(functionPath))
+        functionString = stripSqf(FUNCTION_HEADER.replace("%1", functionName) + lineDirective + code)
+        compressed = compressString(functionString)
+        # Store the compressed string as character codes, it contains control characters that file transfers tend to change
+        entries.append("[{0},{1},[{2}],{3}]".format(
+            escapeString(functionName),
+            escapeString(functionString),
+            ",".join(str(ord(char)) for char in compressed),
+            escapeString(hashString(compressed))
+        ))
+        totalSize += len(functionString)
+        compressedSize += len(compressed)
+
+    with open(outputPath, 'w', encoding='utf-8', newline='\n') as file:
+        file.write("[{0},[{1}]]".format(escapeString(version), ",".join(entries)))
+
+    print("------\nPrebuilt {0} functions for version {1}\nSize: {2} Compressed: {3}\nWritten to {4}".format(len(entries), version, totalSize, compressedSize, outputPath))
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())